@@ -0,0 +1,488 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <hash_set/bounded_hash_set.hpp>
+#include <hash_set/cuckoo_hash_set.hpp>
+#include <hash_set/fixed_hash_set.hpp>
+#include <hash_set/hash_map.hpp>
+#include <hash_set/hash_set.hpp>
+#include <hash_set/huge_page_resource.hpp>
+#include <hash_set/parallel.hpp>
+#include <hash_set/snapshot_hash_set.hpp>
+#include <hash_set/spillable_hash_set.hpp>
+#include <hash_set/static_hash_set.hpp>
+#include <iostream>
+#include <iterator>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template <typename Function>
+void measure(const std::string& name, std::size_t operations, Function fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  const auto finish = std::chrono::steady_clock::now();
+  const double ns =
+      std::chrono::duration<double, std::nano>(finish - start).count();
+  std::cout << name << ": " << ns / static_cast<double>(operations)
+            << " ns/op (" << operations << " ops)" << std::endl;
+}
+
+// Simulates request-scoped sets: each request builds a small set, probes it
+// and throws it away.
+void benchRequestScopedSets() {
+  constexpr std::size_t requests = 20000;
+  constexpr int keys_per_request = 256;
+  std::size_t hits = 0;
+
+  measure("request set, default resource", requests, [&] {
+    for (std::size_t r = 0; r < requests; ++r) {
+      HashSet<int> set;
+      for (int i = 0; i < keys_per_request; ++i) {
+        set.insert(i * 7);
+      }
+      hits += set.contains(static_cast<int>(r % keys_per_request) * 7);
+    }
+  });
+
+  measure("request set, monotonic arena", requests, [&] {
+    for (std::size_t r = 0; r < requests; ++r) {
+      std::pmr::monotonic_buffer_resource arena(64 * 1024);
+      HashSet<int> set(&arena);
+      for (int i = 0; i < keys_per_request; ++i) {
+        set.insert(i * 7);
+      }
+      hits += set.contains(static_cast<int>(r % keys_per_request) * 7);
+    }
+  });
+
+  std::cout << "  (hits: " << hits << ")" << std::endl;
+}
+
+template <typename Set>
+void benchRandomLookups(
+    const std::string& name,
+    Set& set,
+    std::size_t elements,
+    std::size_t lookups) {
+  for (std::size_t i = 0; i < elements; ++i) {
+    set.insert(static_cast<long>(i));
+  }
+  std::mt19937_64 rng(42);
+  std::size_t hits = 0;
+  measure(name, lookups, [&] {
+    for (std::size_t i = 0; i < lookups; ++i) {
+      hits += set.contains(static_cast<long>(rng() % (2 * elements)));
+    }
+  });
+  std::cout << "  (hits: " << hits << ")" << std::endl;
+}
+
+// Random lookups over a large table, with the bucket array on regular pages
+// and on 2 MiB pages. The gap grows with table size; pass an element count
+// large enough to push the table past 1 GiB to see the TLB effect.
+void benchHugePages(std::size_t elements) {
+  constexpr std::size_t lookups = 1 << 22;
+  {
+    HashSet<long> set;
+    benchRandomLookups("random lookup, 4 KiB pages", set, elements, lookups);
+  }
+  {
+    HugePageResource resource;
+    HashSet<long> set(&resource);
+    benchRandomLookups("random lookup, 2 MiB pages", set, elements, lookups);
+  }
+}
+
+// Cost of handing a consistent view to a reader: a deep HashSet copy versus
+// a segment-sharing snapshot followed by a burst of writer modifications.
+void benchSnapshots(std::size_t elements) {
+  constexpr std::size_t rounds = 10;
+  constexpr long writes_per_round = 1000;
+
+  HashSet<long> set;
+  SnapshotHashSet<long> shared;
+  for (std::size_t i = 0; i < elements; ++i) {
+    set.insert(static_cast<long>(i));
+    shared.insert(static_cast<long>(i));
+  }
+
+  std::size_t total = 0;
+  measure("deep copy + writes", rounds, [&] {
+    for (std::size_t r = 0; r < rounds; ++r) {
+      HashSet<long> view(set);
+      for (long i = 0; i < writes_per_round; ++i) {
+        set.insert(static_cast<long>(elements) + i);
+      }
+      total += view.size();
+    }
+  });
+  measure("snapshot + writes", rounds, [&] {
+    for (std::size_t r = 0; r < rounds; ++r) {
+      SnapshotHashSet<long> view = shared.snapshot();
+      for (long i = 0; i < writes_per_round; ++i) {
+        shared.insert(static_cast<long>(elements) + i);
+      }
+      total += view.size();
+    }
+  });
+  std::cout << "  (total: " << total << ")" << std::endl;
+}
+
+template <typename T, typename MakeValue>
+void benchCopies(
+    const std::string& type_name,
+    std::size_t elements,
+    MakeValue make_value) {
+  constexpr std::size_t rounds = 5;
+  HashSet<T> source;
+  for (std::size_t i = 0; i < elements; ++i) {
+    source.insert(make_value(i));
+  }
+
+  std::size_t total = 0;
+  measure("copy construct " + type_name, rounds * elements, [&] {
+    for (std::size_t r = 0; r < rounds; ++r) {
+      HashSet<T> copy(source);
+      total += copy.size();
+    }
+  });
+  HashSet<T> target(source);
+  measure("copy assign " + type_name, rounds * elements, [&] {
+    for (std::size_t r = 0; r < rounds; ++r) {
+      target = source;
+      total += target.size();
+    }
+  });
+  std::cout << "  (total: " << total << ")" << std::endl;
+}
+
+template <typename Set>
+void reportLookupLatency(const std::string& name, const Set& set, long keys) {
+  std::vector<double> samples;
+  samples.reserve(static_cast<std::size_t>(keys));
+  std::size_t hits = 0;
+  for (long i = 0; i < keys; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    hits += set.contains(i * 65536);
+    const auto finish = std::chrono::steady_clock::now();
+    samples.push_back(
+        std::chrono::duration<double, std::nano>(finish - start).count());
+  }
+  std::sort(samples.begin(), samples.end());
+  const auto percentile = [&samples](double p) {
+    return samples[static_cast<std::size_t>(p * (samples.size() - 1))];
+  };
+  std::cout << name << ": p50 " << percentile(0.5) << " ns, p99.99 "
+            << percentile(0.9999) << " ns, max " << samples.back()
+            << " ns (hits: " << hits << ")" << std::endl;
+}
+
+// Keys that are multiples of 2^16 all land in the same chain of a HashSet
+// with at most 2^16 buckets, since std::hash is the identity for integers.
+void benchCollisionHeavyLookups() {
+  constexpr long keys = 20000;
+  HashSet<long> chained;
+  CuckooHashSet<long> cuckoo;
+  for (long i = 0; i < keys; ++i) {
+    chained.insert(i * 65536);
+    cuckoo.insert(i * 65536);
+  }
+  reportLookupLatency("colliding keys, chained", chained, keys);
+  reportLookupLatency("colliding keys, cuckoo", cuckoo, keys);
+}
+
+// Insert and lookup throughput as the memory budget shrinks below the
+// data size (about 24 bytes per key as accounted by SpillableHashSet).
+void benchSpilling(std::size_t elements) {
+  const auto directory =
+      std::filesystem::temp_directory_path() / "hash_set_bench_spill";
+  const std::size_t data_bytes = elements * 24;
+  const std::pair<std::string, std::size_t> budgets[] = {
+      {"2x data", data_bytes * 2},
+      {"1/4 of data", data_bytes / 4},
+      {"1/16 of data", data_bytes / 16},
+  };
+  for (const auto& [label, budget] : budgets) {
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const std::string suffix = ", budget " + label;
+    SpillableHashSet<long> set(budget, directory.string());
+    measure("spillable insert" + suffix, elements, [&] {
+      for (std::size_t i = 0; i < elements; ++i) {
+        set.insert(static_cast<long>(i));
+      }
+    });
+    std::mt19937_64 rng(7);
+    constexpr std::size_t lookups = 100000;
+    std::size_t hits = 0;
+    measure("spillable lookup" + suffix, lookups, [&] {
+      for (std::size_t i = 0; i < lookups; ++i) {
+        hits += set.contains(static_cast<long>(rng() % (2 * elements)));
+      }
+    });
+    std::cout << "  (spilled partitions: " << set.spilled_partitions()
+              << ", hits: " << hits << ")" << std::endl;
+  }
+  std::filesystem::remove_all(directory);
+}
+
+// Sliding-window dedup over a stream of event ids: a HashSet cleared every
+// window versus a BoundedHashSet capped at the window size. Reports the
+// distribution of single-insert latencies.
+void benchSlidingWindow(std::size_t window) {
+  const std::size_t events = window * 8;
+  std::mt19937_64 rng(11);
+  std::vector<long> ids(events);
+  for (auto& id : ids) {
+    id = static_cast<long>(rng() % (window * 4));
+  }
+
+  const auto run = [&ids](const std::string& name, auto&& insert) {
+    std::vector<double> samples;
+    samples.reserve(ids.size());
+    std::size_t accepted = 0;
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+      const auto before = std::chrono::steady_clock::now();
+      accepted += insert(i, ids[i]);
+      const auto after = std::chrono::steady_clock::now();
+      samples.push_back(
+          std::chrono::duration<double, std::nano>(after - before).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    std::cout << name << ": p50 " << samples[samples.size() / 2]
+              << " ns, p99.99 "
+              << samples[static_cast<std::size_t>(0.9999 * samples.size())]
+              << " ns, max " << samples.back() << " ns (accepted: "
+              << accepted << ")" << std::endl;
+  };
+
+  HashSet<long> periodic;
+  run("window dedup, periodic clear", [&](std::size_t i, long id) {
+    if (i % window == 0) {
+      periodic.clear();
+    }
+    return periodic.insert(id);
+  });
+  BoundedHashSet<long> bounded(window);
+  run("window dedup, bounded set", [&](std::size_t, long id) {
+    return bounded.insert(id);
+  });
+}
+
+// Full-set reduction with an increasing number of threads.
+void benchParallelReduce(std::size_t elements) {
+  HashSet<long> set;
+  for (std::size_t i = 0; i < elements; ++i) {
+    set.insert(static_cast<long>(i));
+  }
+  long total = 0;
+  for (const std::size_t threads : {1, 2, 4, 8}) {
+    measure(
+        "parallel_reduce, " + std::to_string(threads) + " threads",
+        elements,
+        [&] {
+          total += parallel_reduce(
+              set,
+              0L,
+              [](long acc, long value) { return acc + value; },
+              [](long lhs, long rhs) { return lhs + rhs; },
+              threads);
+        });
+  }
+  std::cout << "  (total: " << total << ")" << std::endl;
+}
+
+// Keyword classification: a compile-time perfect-hash table against a
+// HashSet filled at startup.
+void benchKeywordLookups() {
+  static constexpr std::string_view words[] = {
+      "auto",     "break",  "case",    "char",   "const",    "continue",
+      "default",  "do",     "double",  "else",   "enum",     "extern",
+      "float",    "for",    "goto",    "if",     "int",      "long",
+      "register", "return", "short",   "signed", "sizeof",   "static",
+      "struct",   "switch", "typedef", "union",  "unsigned", "void",
+      "volatile", "while"};
+  static constexpr auto keywords = make_static_hash_set(words);
+  HashSet<std::string_view> runtime;
+  for (const std::string_view word : words) {
+    runtime.insert(word);
+  }
+
+  const std::string_view identifiers[] = {
+      "int",   "main", "argc", "char", "argv", "if",     "return",
+      "count", "for",  "i",    "size", "while", "struct", "node"};
+  std::mt19937 rng(42);
+  std::vector<std::string_view> tokens(4096);
+  for (std::string_view& token : tokens) {
+    token = identifiers[rng() % std::size(identifiers)];
+  }
+  constexpr std::size_t lookups = 1 << 22;
+  std::size_t hits = 0;
+  measure("keyword lookup, HashSet", lookups, [&] {
+    for (std::size_t i = 0; i < lookups; ++i) {
+      hits += runtime.contains(tokens[i & 4095]);
+    }
+  });
+  measure("keyword lookup, StaticHashSet", lookups, [&] {
+    for (std::size_t i = 0; i < lookups; ++i) {
+      hits += keywords.contains(tokens[i & 4095]);
+    }
+  });
+  std::cout << "  (hits: " << hits << ")" << std::endl;
+}
+
+// The same key-value workloads on HashMap and std::unordered_map: integer
+// inserts through operator[], random lookups, and word counting.
+template <typename Map, typename WordMap>
+void benchMapWorkloads(
+    const std::string& name,
+    std::size_t elements,
+    const std::vector<std::string>& words) {
+  std::mt19937_64 rng(42);
+  long total = 0;
+  {
+    Map map;
+    measure(name + ", insert", elements, [&] {
+      for (std::size_t i = 0; i < elements; ++i) {
+        map[static_cast<long>(i)] = static_cast<long>(i);
+      }
+    });
+    measure(name + ", random lookup", elements, [&] {
+      for (std::size_t i = 0; i < elements; ++i) {
+        const auto it = map.find(static_cast<long>(rng() % (2 * elements)));
+        total += it != map.end() ? it->second : 0;
+      }
+    });
+  }
+  WordMap counts;
+  measure(name + ", word count", words.size(), [&] {
+    for (const std::string& word : words) {
+      ++counts[word];
+    }
+  });
+  std::cout << "  (total: " << total << ", distinct words: " << counts.size()
+            << ")" << std::endl;
+}
+
+void benchMaps(std::size_t elements) {
+  std::mt19937_64 rng(7);
+  std::vector<std::string> words(elements);
+  for (std::string& word : words) {
+    word = "word-" + std::to_string(rng() % (elements / 8 + 1));
+  }
+  benchMapWorkloads<HashMap<long, long>, HashMap<std::string, int>>(
+      "HashMap", elements, words);
+  benchMapWorkloads<
+      std::unordered_map<long, long>,
+      std::unordered_map<std::string, int>>(
+      "std::unordered_map", elements, words);
+}
+
+// Steady-state churn at a fixed population of random keys: every step
+// inserts a new key and erases the oldest one. HashSet allocates and frees
+// a node per step; FixedHashSet reuses its pool slots.
+void benchFixedCapacity(std::size_t operations) {
+  constexpr std::size_t population = 1 << 16;
+  std::mt19937_64 rng(3);
+  std::vector<long> keys(operations);
+  for (long& key : keys) {
+    key = static_cast<long>(rng() >> 1);
+  }
+  std::size_t accepted = 0;
+
+  HashSet<long> dynamic;
+  measure("churn, HashSet", operations, [&] {
+    for (std::size_t i = 0; i < operations; ++i) {
+      accepted += dynamic.insert(keys[i]);
+      if (i >= population) {
+        dynamic.erase(keys[i - population]);
+      }
+    }
+  });
+  FixedHashSet<long> fixed(population);
+  measure("churn, FixedHashSet", operations, [&] {
+    for (std::size_t i = 0; i < operations; ++i) {
+      if (i >= population) {
+        fixed.erase(keys[i - population]);
+      }
+      accepted += fixed.insert(keys[i]) ==
+          FixedHashSet<long>::insert_result::inserted;
+    }
+  });
+  std::cout << "  (accepted: " << accepted << ")" << std::endl;
+}
+
+// Sorted export: the usual copy into a vector plus std::sort, against
+// to_sorted_vector(), and a repeated comparison served from the cache.
+template <typename T, typename Make>
+void benchSortedExport(
+    const std::string& name,
+    std::size_t elements,
+    Make make) {
+  HashSet<T> set;
+  std::mt19937_64 rng(5);
+  for (std::size_t i = 0; i < elements; ++i) {
+    set.insert(make(rng()));
+  }
+  std::size_t checksum = 0;
+
+  measure(name + " copy + std::sort", elements, [&] {
+    std::vector<T> values(set.begin(), set.end());
+    std::sort(values.begin(), values.end());
+    checksum += values.size();
+  });
+  measure(name + " to_sorted_vector", elements, [&] {
+    checksum += set.to_sorted_vector().size();
+  });
+  const HashSet<T> copy(set);
+  checksum += copy < set;
+  measure(name + " operator< (cached)", elements, [&] {
+    checksum += set < copy;
+  });
+  std::cout << "  (checksum: " << checksum << ")" << std::endl;
+}
+
+}  // namespace
+
+// Usage: hash_set_bench [large table elements]
+int main(int argc, char* argv[]) {
+  const std::size_t large_elements =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 22;
+
+  benchRequestScopedSets();
+  benchHugePages(large_elements);
+  benchSnapshots(large_elements);
+  benchCollisionHeavyLookups();
+  benchSpilling(large_elements / 4);
+  benchSlidingWindow(large_elements / 4);
+  benchParallelReduce(large_elements);
+  benchKeywordLookups();
+  benchMaps(large_elements / 4);
+  benchFixedCapacity(large_elements);
+  benchSortedExport<long>(
+      "HashSet<long>", large_elements / 4, [](std::uint64_t random) {
+        return static_cast<long>(random);
+      });
+  benchSortedExport<std::string>(
+      "HashSet<std::string>", large_elements / 4, [](std::uint64_t random) {
+        return std::to_string(random);
+      });
+  benchCopies<int>("HashSet<int>", large_elements / 4, [](std::size_t i) {
+    return static_cast<int>(i);
+  });
+  benchCopies<std::string>(
+      "HashSet<std::string>", large_elements / 4, [](std::size_t i) {
+        return "key-with-some-length-" + std::to_string(i);
+      });
+  return 0;
+}
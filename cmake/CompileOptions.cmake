@@ -1,5 +1,11 @@
 function(set_compile_options target_name)
-  target_compile_options(${target_name} PRIVATE -O0 -g  -Wall -Wextra -Werror -pedantic)
+  target_compile_options(${target_name} PRIVATE -Wall -Wextra -Werror -pedantic)
+  target_compile_options(
+    ${target_name}
+    PRIVATE
+      $<$<NOT:$<CONFIG:Release>>:-O0>
+      $<$<NOT:$<CONFIG:Release>>:-g>
+  )
 
   set_target_properties(
     ${target_name}
@@ -0,0 +1,56 @@
+#ifndef DEDUPLICATOR_HPP
+#define DEDUPLICATOR_HPP
+
+#include <cstddef>
+#include <hash_set/hash_set.hpp>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class WorkerPool;
+
+// Filters batches of lines down to their first occurrences. Lines are kept
+// as std::string_view; when the caller's buffer is about to be reused the
+// distinct lines are first copied into an append-only arena. With several
+// threads the key space is sharded by hash and every shard is owned by one
+// thread, so no locking is needed and output order is preserved.
+class Deduplicator {
+ public:
+  explicit Deduplicator(std::size_t threads);
+  ~Deduplicator();
+
+  // Appends every line not seen before to output, each followed by '\n'.
+  // If transient is true the memory behind lines may be reused after the
+  // call returns.
+  void process(
+      const std::vector<std::string_view>& lines,
+      bool transient,
+      std::string& output);
+  std::size_t distinct() const noexcept;
+
+ private:
+  struct Shard {
+    std::pmr::monotonic_buffer_resource arena;
+    HashSet<std::string_view> seen;
+
+    Shard();
+  };
+
+  std::vector<std::unique_ptr<Shard>> m_shards;
+  std::unique_ptr<WorkerPool> m_pool;
+  std::vector<char> m_keep;
+  // Line indices of the current batch, by the worker that hashed them and
+  // then by the shard that owns them.
+  std::vector<std::vector<std::vector<std::size_t>>> m_routed;
+
+  void route(std::size_t worker, const std::vector<std::string_view>& lines);
+  void keepFirst(
+      Shard& shard,
+      std::size_t index,
+      std::string_view line,
+      bool transient);
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef LINE_INPUT_HPP
+#define LINE_INPUT_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <dedup/deduplicator.hpp>
+
+enum class input_status { done, not_mapped, read_error, write_error };
+
+// Feed every line read from fd through dedup and write the kept lines to
+// out, adding the number of input bytes to bytes. A last line without a
+// trailing '\n' is treated like any other. out is flushed before they
+// return; if a write or the flush fails they stop and report write_error,
+// with errno describing the failure.
+//
+// dedupMapped maps a regular, non-empty file and references its lines in
+// place; it returns not_mapped without reading anything for other
+// descriptors. The mapping is gone when it returns, so dedup must not be
+// given further lines afterwards. dedupStream reads any descriptor, such as
+// a pipe, in chunks and returns read_error if a read fails.
+input_status dedupMapped(
+    int fd,
+    Deduplicator& dedup,
+    std::FILE* out,
+    std::size_t& bytes);
+input_status dedupStream(
+    int fd,
+    Deduplicator& dedup,
+    std::FILE* out,
+    std::size_t& bytes);
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef BOUNDED_HASHSET_HPP
+#define BOUNDED_HASHSET_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <new>
+
+// Hash set for sliding-window deduplication. It holds at most max_size
+// elements and, if ttl is non-zero, forgets elements ttl after they were
+// inserted. Elements are threaded through an intrusive list in insertion
+// order, so making room for a new element evicts the oldest one in O(1).
+// Expired elements are treated as absent right away and reclaimed a few at
+// a time by later inserts, never by a full sweep. All nodes are allocated
+// up front; the set does not allocate after construction (beyond what T's
+// copy constructor does).
+template <typename T>
+class BoundedHashSet {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  explicit BoundedHashSet(
+      std::size_t max_size,
+      clock::duration ttl = clock::duration::zero());
+  BoundedHashSet(const BoundedHashSet& other) = delete;
+  ~BoundedHashSet();
+
+  BoundedHashSet& operator=(const BoundedHashSet& other) = delete;
+
+  // Returns false if an equal, unexpired element was already present; its
+  // age is not refreshed.
+  bool insert(const T& value);
+  bool insert(const T& value, clock::time_point now);
+  bool contains(const T& value) const;
+  bool contains(const T& value, clock::time_point now) const;
+  void erase(const T& value);
+  void clear() noexcept;
+  bool empty() const noexcept;
+  // Counts elements that have not been evicted yet, which may include some
+  // that have already expired.
+  std::size_t size() const noexcept;
+  std::size_t max_size() const noexcept;
+
+ private:
+  // Upper bound on expired elements reclaimed by a single insert; above one
+  // so the backlog shrinks even while every call inserts.
+  static constexpr std::size_t EXPIRE_BATCH = 4;
+  static constexpr double LOAD_FACTOR = 0.75;
+
+  // Pool slots are plain storage; value is only alive while the slot is
+  // linked into the set, and next doubles as the free-list link.
+  struct Node {
+    Node* next;
+    Node* older;
+    Node* newer;
+    clock::time_point inserted;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T& value() noexcept;
+    const T& value() const noexcept;
+  };
+
+  Node** m_data;
+  std::size_t m_capacity;
+  Node* m_pool;
+  Node* m_free;
+  Node* m_oldest;
+  Node* m_newest;
+  std::size_t m_maxSize;
+  std::size_t m_size;
+  clock::duration m_ttl;
+
+  std::size_t bucketIndex(const T& value) const;
+  Node* find(const T& value) const;
+  bool expired(const Node* node, clock::time_point now) const noexcept;
+  void remove(Node* node) noexcept;
+};
+
+#endif
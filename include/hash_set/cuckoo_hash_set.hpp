@@ -0,0 +1,103 @@
+#ifndef CUCKOO_HASHSET_HPP
+#define CUCKOO_HASHSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+// Bucketized cuckoo hash set: every element lives in one of the 4-slot
+// buckets picked by two independent hash functions, or in a small stash.
+// A lookup therefore inspects at most two buckets (plus the stash when it is
+// non-empty) however the keys collide. Inserts move residents to their
+// alternate bucket along a bounded path; when that fails and the stash is
+// full the table is rebuilt with a new seed and twice the buckets.
+// Both buckets derive from the same std::hash value, so keys that share it
+// (such as NaNs) cannot be separated by any seed or size. An element that
+// still finds no slot after one rebuild goes to an overflow list that
+// lookups scan instead, and further failures go there without rebuilding
+// until the load factor grows the table, which retries them.
+template <typename T>
+class CuckooHashSet {
+ public:
+  CuckooHashSet();
+  CuckooHashSet(const CuckooHashSet& other);
+  CuckooHashSet(CuckooHashSet&& other) noexcept;
+  CuckooHashSet(std::initializer_list<T> values);
+  ~CuckooHashSet();
+
+  CuckooHashSet& operator=(const CuckooHashSet& other);
+  CuckooHashSet& operator=(CuckooHashSet&& other) noexcept;
+
+  void insert(const T& value);
+  void erase(const T& value);
+  void clear() noexcept;
+  bool contains(const T& value) const;
+  bool empty() const noexcept;
+  std::size_t size() const noexcept;
+  std::size_t bucket_count() const noexcept;
+
+  template <typename Function>
+  void for_each(Function fn) const;
+
+ private:
+  static constexpr std::size_t SLOTS = 4;
+  static constexpr std::size_t STASH_SIZE = 4;
+  static constexpr std::size_t DEFAULT_BUCKETS = 4;
+  static constexpr std::size_t MAX_DISPLACEMENTS = 128;
+  static constexpr double LOAD_FACTOR = 0.9;
+
+  struct Slots {
+    T values[SLOTS];
+    std::uint8_t occupied;
+  };
+
+  static constexpr std::size_t BUCKET_ALIGNMENT = sizeof(Slots) <= 16
+      ? 16
+      : sizeof(Slots) <= 32 ? 32
+                            : 64;
+
+  // Padded to the next power of two (up to a cache line) so that a bucket
+  // of small keys never straddles two lines.
+  struct alignas(BUCKET_ALIGNMENT) Bucket : Slots {};
+
+  Bucket* m_buckets;
+  std::size_t m_bucketCount;
+  std::size_t m_size;
+  std::uint64_t m_seed;
+  std::uint64_t m_random;
+  T m_stash[STASH_SIZE];
+  std::size_t m_stashSize;
+  std::vector<T> m_overflow;
+
+  std::size_t firstBucket(std::size_t hash) const noexcept;
+  std::size_t secondBucket(std::size_t hash) const noexcept;
+  static bool findInBucket(const Bucket& bucket, const T& value);
+  static bool placeInBucket(Bucket& bucket, T& value);
+  bool place(T& value);
+  void grow();
+  void rebuild(std::size_t buckets);
+  void copyFrom(const CuckooHashSet& other);
+  void moveFrom(CuckooHashSet&& other) noexcept;
+};
+
+template <typename T>
+template <typename Function>
+void CuckooHashSet<T>::for_each(Function fn) const {
+  for (std::size_t b = 0; b < m_bucketCount; ++b) {
+    const Bucket& bucket = m_buckets[b];
+    for (std::size_t s = 0; s < SLOTS; ++s) {
+      if (bucket.occupied & (1u << s)) {
+        fn(bucket.values[s]);
+      }
+    }
+  }
+  for (std::size_t s = 0; s < m_stashSize; ++s) {
+    fn(m_stash[s]);
+  }
+  for (const T& value : m_overflow) {
+    fn(value);
+  }
+}
+
+#endif
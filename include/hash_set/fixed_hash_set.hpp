@@ -0,0 +1,90 @@
+#ifndef FIXED_HASHSET_HPP
+#define FIXED_HASHSET_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+// Hash set for code that must not allocate, such as packet-processing
+// threads. The bucket array and max_size element slots are taken from
+// resource in a single allocation by the constructor; after that nothing
+// allocates, every operation is noexcept, and insert reports a full set
+// instead of growing. To use a caller-provided buffer, pass a
+// std::pmr::monotonic_buffer_resource over at least buffer_size(max_size)
+// bytes with std::pmr::null_memory_resource() upstream.
+//
+// Hashes are mixed and the buckets are kept at most half full, so chains
+// are short. They are also capped at MAX_CHAIN elements, so every
+// operation makes at most MAX_CHAIN comparisons, even with adversarial
+// keys. An insert that would exceed the cap fails like a full set.
+template <typename T>
+class FixedHashSet {
+  static_assert(
+      std::is_nothrow_copy_constructible_v<T> &&
+          std::is_nothrow_destructible_v<T>,
+      "FixedHashSet elements must be copied without allocating");
+
+ public:
+  enum class insert_result { inserted, present, full };
+
+  static constexpr std::size_t MAX_CHAIN = 16;
+
+  explicit FixedHashSet(
+      std::size_t max_size,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+  FixedHashSet(const FixedHashSet& other) = delete;
+  ~FixedHashSet();
+
+  FixedHashSet& operator=(const FixedHashSet& other) = delete;
+
+  // Bytes a monotonic buffer needs to hold the storage for max_size
+  // elements, including alignment slack.
+  static std::size_t buffer_size(std::size_t max_size) noexcept;
+
+  insert_result insert(const T& value) noexcept;
+  bool contains(const T& value) const noexcept;
+  void erase(const T& value) noexcept;
+  void clear() noexcept;
+  bool empty() const noexcept;
+  std::size_t size() const noexcept;
+  std::size_t max_size() const noexcept;
+
+  template <typename Function>
+  void for_each(Function fn) const;
+
+ private:
+  // Pool slots are plain storage; value is only alive while the slot is
+  // linked into a bucket, and next doubles as the free-list link.
+  struct Node {
+    Node* next;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T& value() noexcept;
+    const T& value() const noexcept;
+  };
+
+  std::pmr::memory_resource* m_resource;
+  Node* m_pool;
+  Node** m_data;
+  std::size_t m_capacity;
+  Node* m_free;
+  std::size_t m_maxSize;
+  std::size_t m_size;
+
+  static std::size_t bucketCount(std::size_t max_size) noexcept;
+  static std::size_t storageBytes(std::size_t max_size) noexcept;
+  std::size_t bucketIndex(const T& value) const noexcept;
+};
+
+template <typename T>
+template <typename Function>
+void FixedHashSet<T>::for_each(Function fn) const {
+  for (std::size_t i = 0; i < m_capacity; ++i) {
+    for (const Node* node = m_data[i]; node != nullptr; node = node->next) {
+      fn(node->value());
+    }
+  }
+}
+
+#endif
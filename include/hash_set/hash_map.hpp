@@ -0,0 +1,101 @@
+#ifndef HASHMAP_HPP
+#define HASHMAP_HPP
+
+#include <cstddef>
+#include <hash_set/hash_set.hpp>
+#include <initializer_list>
+#include <memory_resource>
+#include <tuple>
+#include <utility>
+
+// Key-value map on the HashSet table: the elements are std::pair<const K, V>
+// keyed on first, so hashing, rehashing, iteration, memory resources and
+// copy-by-block all come from HashSet. Each value is stored inline with its
+// key in the same node. Like std::unordered_map this is a chained table
+// with one node per entry, not a flat open-addressing array: a flat layout
+// would need a second table core, since HashSet itself is chained, and
+// would give up the reference stability across rehash that the set
+// guarantees. Only copies get their nodes in one contiguous block; inserted
+// entries are allocated one by one from the memory resource, which is what
+// insertion pays for compared with a flat map.
+template <typename K, typename V>
+class HashMap {
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using iterator = typename HashSet<value_type, FirstKey>::iterator;
+  using const_iterator = iterator;
+
+  HashMap();
+  explicit HashMap(std::pmr::memory_resource* resource);
+  HashMap(const HashMap& other, std::pmr::memory_resource* resource);
+  HashMap(
+      std::initializer_list<value_type> values,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  bool operator==(const HashMap& other) const;
+  bool operator!=(const HashMap& other) const;
+
+  // Constructs the value from args only if key is absent.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args);
+  // Inserts, or assigns to the existing value; second is true on insert.
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& value);
+  // Returns false if key was already present; the value is left unchanged.
+  bool insert(const value_type& value);
+  V& operator[](const K& key);
+  // Throws std::out_of_range if key is absent.
+  V& at(const K& key);
+  const V& at(const K& key) const;
+
+  iterator find(const K& key) const;
+  bool contains(const K& key) const;
+  std::size_t erase(const K& key);
+  iterator erase(const_iterator pos);
+  void clear() noexcept;
+  bool empty() const noexcept;
+  std::size_t size() const noexcept;
+  std::pmr::memory_resource* resource() const noexcept;
+
+  iterator begin() const noexcept;
+  iterator end() const noexcept;
+
+ private:
+  HashSet<value_type, FirstKey> m_table;
+};
+
+template <typename K, typename V>
+template <typename... Args>
+std::pair<typename HashMap<K, V>::iterator, bool> HashMap<K, V>::try_emplace(
+    const K& key,
+    Args&&... args) {
+  const std::size_t bucket = m_table.bucketOf(key);
+  if (auto* node = m_table.findNode(key, bucket)) {
+    return {m_table.iteratorAt(node, bucket), false};
+  }
+  return {m_table.insertUnique(
+              value_type(
+                  std::piecewise_construct,
+                  std::forward_as_tuple(key),
+                  std::forward_as_tuple(std::forward<Args>(args)...)),
+              bucket),
+          true};
+}
+
+template <typename K, typename V>
+template <typename M>
+std::pair<typename HashMap<K, V>::iterator, bool>
+HashMap<K, V>::insert_or_assign(const K& key, M&& value) {
+  const std::size_t bucket = m_table.bucketOf(key);
+  if (auto* node = m_table.findNode(key, bucket)) {
+    node->value.second = std::forward<M>(value);
+    return {m_table.iteratorAt(node, bucket), false};
+  }
+  return {m_table.insertUnique(
+              value_type(key, std::forward<M>(value)), bucket),
+          true};
+}
+
+#endif
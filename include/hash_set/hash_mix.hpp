@@ -0,0 +1,19 @@
+#ifndef HASH_MIX_HPP
+#define HASH_MIX_HPP
+
+#include <cstdint>
+
+// splitmix64 finalizer: spreads every input bit over the whole word, so
+// std::hash results (the identity for integers) can be cut into bucket,
+// partition or filter indices independently. constexpr so that
+// StaticHashSet can build its tables at compile time with it.
+constexpr std::uint64_t mix(std::uint64_t x) noexcept {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+#endif
@@ -1,38 +1,104 @@
 #ifndef HASHSET_HPP
 #define HASHSET_HPP
 
-template <typename T>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Key-extraction policies. The table hashes and compares KeyOf()(element),
+// so the same code serves sets, where an element is its own key, and
+// HashMap, whose elements are key-value pairs.
+struct IdentityKey {
+  template <typename T>
+  const T& operator()(const T& value) const noexcept {
+    return value;
+  }
+};
+
+struct FirstKey {
+  template <typename Pair>
+  const typename Pair::first_type& operator()(const Pair& pair) const noexcept {
+    return pair.first;
+  }
+};
+
+template <typename K, typename V>
+class HashMap;
+
+template <typename T, typename KeyOf = IdentityKey>
 class HashSet {
  public:
+  using value_type = T;
+  using key_type = std::remove_cv_t<std::remove_reference_t<
+      decltype(std::declval<KeyOf>()(std::declval<const T&>()))>>;
+
   class iterator;
+  class bucket_range;
+  using const_iterator = iterator;
 
   HashSet();
+  // Every node and bucket array is taken from resource, which must outlive
+  // the set. With a std::pmr::monotonic_buffer_resource the destructor skips
+  // the per-node deallocation walk and leaves the memory to the arena.
+  // Copies use the default resource unless one is given; moves carry the
+  // source's resource along with its storage.
+  explicit HashSet(std::pmr::memory_resource* resource);
   HashSet(const HashSet& other);
+  HashSet(const HashSet& other, std::pmr::memory_resource* resource);
   HashSet(HashSet&& other) noexcept;
-  HashSet(std::initializer_list<T> values);
+  HashSet(
+      std::initializer_list<T> values,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
   ~HashSet();
 
   HashSet& operator=(const HashSet& other);
   HashSet& operator=(HashSet&& other) noexcept;
-  bool operator==(const HashSet<T>& other) const;
-  bool operator!=(const HashSet<T>& other) const;
-  bool operator<(const HashSet<T>& other) const;
-  bool operator>(const HashSet<T>& other) const;
-  bool operator<=(const HashSet<T>& other) const;
-  bool operator>=(const HashSet<T>& other) const;
-
-  void insert(const T& value);
+  bool operator==(const HashSet& other) const;
+  bool operator!=(const HashSet& other) const;
+  // Ordering compares the sorted elements lexicographically, so it does not
+  // depend on capacity or insertion history.
+  bool operator<(const HashSet& other) const;
+  bool operator>(const HashSet& other) const;
+  bool operator<=(const HashSet& other) const;
+  bool operator>=(const HashSet& other) const;
+
+  // Returns false if an equal element was already present.
+  bool insert(const T& value);
   void clear() noexcept;
   bool contains(const T& value) const;
   bool empty() const noexcept;
   void erase(const T& value);
+  iterator erase(const_iterator pos);
   std::size_t size() const noexcept;
+  std::pmr::memory_resource* resource() const noexcept;
+
+  template <typename U, typename K, typename Predicate>
+  friend std::size_t erase_if(HashSet<U, K>& set, Predicate pred);
 
   iterator begin() noexcept;
   iterator begin() const noexcept;
   iterator end() noexcept;
   iterator end() const noexcept;
 
+  // The elements in ascending order. Integral elements are radix sorted,
+  // large sets of other types are sorted on several threads. The order is
+  // cached until the next modification, so repeated calls and comparisons
+  // are cheap; the returned reference is only valid until then. Concurrent
+  // const calls are safe, the cache being filled under a lock; any
+  // modification frees it.
+  const std::vector<T>& ordered_view() const;
+  std::vector<T> to_sorted_vector() const;
+
+  // Splits the bucket array into at most chunks contiguous ranges of equal
+  // bucket count that together visit every element once. Intended for
+  // handing disjoint parts of the set to different threads.
+  std::vector<bucket_range> partition(std::size_t chunks) const;
+
  private:
   struct Node {
     T value;
@@ -44,20 +110,57 @@ class HashSet {
     }
   };
 
+  template <typename K, typename V>
+  friend class HashMap;
+
   static constexpr std::size_t DEFAULT_CAPACITY = 16;
   static constexpr double LOAD_FACTOR = 0.75;
 
+  std::pmr::memory_resource* m_resource;
   Node** m_data;
+  // Always a power of two, so buckets are picked with a mask.
   std::size_t m_capacity;
   std::size_t m_size;
-
+  // Contiguous storage for nodes cloned by the copy constructor or copy
+  // assignment; individual nodes in it are never deallocated on their own,
+  // the whole block is once none of them is live.
+  Node* m_block;
+  std::size_t m_blockCapacity;
+  std::size_t m_blockLive;
+  // Sorted copy of the elements, allocated by the first ordered_view()
+  // after a modification so that sets never sorted pay only the pointer.
+  // Readers publish it under a lock shared with other sets; writers, which
+  // never run concurrently with readers, free it without locking.
+  mutable std::atomic<std::vector<T>*> m_sorted;
+
+  Node* createNode(const T& value, Node* next = nullptr);
+  Node* createNode(T&& value, Node* next = nullptr);
+  void destroyNode(Node* node) noexcept;
+  Node* constructNode(Node* slot, const T& value);
+  void allocateBlock(std::size_t count);
+  void releaseBlock() noexcept;
+  bool isBlockNode(const Node* node) const noexcept;
+  Node** allocateBuckets(std::size_t capacity);
+  void deallocateBuckets(Node** data, std::size_t capacity) noexcept;
+  bool isMonotonicResource() const noexcept;
+  void release() noexcept;
   void rehash();
   void copyFrom(const HashSet& other);
+  void assignFrom(const HashSet& other);
   void moveFrom(HashSet&& other) noexcept;
+  iterator firstFrom(std::size_t bucket) const noexcept;
+  void invalidateOrder() noexcept;
+  std::size_t bucketOf(const key_type& key) const;
+  Node* findNode(const key_type& key, std::size_t bucket) const;
+  // Lookup, insertion and removal by key, shared with HashMap.
+  iterator iteratorAt(Node* node, std::size_t bucket) const noexcept;
+  iterator findKey(const key_type& key) const;
+  iterator insertUnique(T&& value, std::size_t bucket);
+  bool eraseKey(const key_type& key);
 
  public:
   class iterator {
-    friend class HashSet<T>;
+    friend class HashSet;
 
    public:
     using iterator_category = std::bidirectional_iterator_tag;
@@ -102,6 +205,51 @@ class HashSet {
 
     void findNextNode();
   };
+
+  class bucket_range {
+    friend class HashSet;
+
+   public:
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+    std::size_t first_bucket() const noexcept;
+    std::size_t last_bucket() const noexcept;
+
+   private:
+    const HashSet* m_set;
+    std::size_t m_first;
+    std::size_t m_last;
+
+    bucket_range(const HashSet* set, std::size_t first, std::size_t last)
+        : m_set(set), m_first(first), m_last(last) {
+    }
+  };
 };
 
+// Removes every element satisfying pred in a single pass over the buckets,
+// unlinking nodes in place. Returns the number of removed elements.
+template <typename T, typename KeyOf, typename Predicate>
+std::size_t erase_if(HashSet<T, KeyOf>& set, Predicate pred) {
+  using Node = typename HashSet<T, KeyOf>::Node;
+  std::size_t removed = 0;
+  for (std::size_t i = 0; i < set.m_capacity; ++i) {
+    Node** link = &set.m_data[i];
+    while (*link != nullptr) {
+      Node* current = *link;
+      if (pred(static_cast<const T&>(current->value))) {
+        *link = current->next;
+        set.destroyNode(current);
+        ++removed;
+      } else {
+        link = &current->next;
+      }
+    }
+  }
+  set.m_size -= removed;
+  if (removed != 0) {
+    set.invalidateOrder();
+  }
+  return removed;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef HUGE_PAGE_RESOURCE_HPP
+#define HUGE_PAGE_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+// Serves allocations of at least threshold bytes from anonymous mappings
+// aligned to 2 MiB and advised with MADV_HUGEPAGE, so that large bucket
+// arrays can be backed by transparent huge pages. Smaller requests, such as
+// individual nodes, go to upstream. If the kernel refuses the advice the
+// mapping simply stays on regular pages.
+class HugePageResource : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20;
+
+  explicit HugePageResource(
+      std::size_t threshold = HUGE_PAGE_SIZE,
+      std::pmr::memory_resource* upstream =
+          std::pmr::get_default_resource()) noexcept;
+
+  std::size_t threshold() const noexcept;
+  std::pmr::memory_resource* upstream() const noexcept;
+
+ private:
+  std::size_t m_threshold;
+  std::pmr::memory_resource* m_upstream;
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+      override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+};
+
+#endif
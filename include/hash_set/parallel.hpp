@@ -0,0 +1,95 @@
+#ifndef HASHSET_PARALLEL_HPP
+#define HASHSET_PARALLEL_HPP
+
+#include <cstddef>
+#include <exception>
+#include <hash_set/hash_set.hpp>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Runs body(range, chunk) for every range of set.partition(threads), one
+// range per thread with the calling thread taking the first. The first
+// exception thrown by any chunk is rethrown after all threads have joined.
+// Any key policy works, so key-value tables are walked the same way.
+template <typename T, typename KeyOf, typename Body>
+void parallel_for_each_range(
+    const HashSet<T, KeyOf>& set,
+    std::size_t threads,
+    Body body) {
+  const auto ranges = set.partition(threads == 0 ? 1 : threads);
+  std::vector<std::exception_ptr> errors(ranges.size());
+  std::vector<std::thread> workers;
+  workers.reserve(ranges.size());
+
+  const auto run = [&](std::size_t chunk) {
+    try {
+      body(ranges[chunk], chunk);
+    } catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  };
+  for (std::size_t chunk = 1; chunk < ranges.size(); ++chunk) {
+    workers.emplace_back(run, chunk);
+  }
+  if (!ranges.empty()) {
+    run(0);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+// Calls fn(value) for every element, concurrently from up to threads
+// threads. fn must be safe to call in parallel.
+template <typename T, typename KeyOf, typename Function>
+void parallel_for_each(
+    const HashSet<T, KeyOf>& set,
+    Function fn,
+    std::size_t threads) {
+  parallel_for_each_range(
+      set, threads, [&fn](const auto& range, std::size_t) {
+        for (auto it = range.begin(), end = range.end(); it != end; ++it) {
+          fn(static_cast<const T&>(*it));
+        }
+      });
+}
+
+// Folds every chunk with reduce(accumulator, value), starting from init,
+// then folds the per-chunk results with combine. init must be an identity
+// of combine, since it seeds every chunk.
+template <
+    typename T,
+    typename KeyOf,
+    typename R,
+    typename Reduce,
+    typename Combine>
+R parallel_reduce(
+    const HashSet<T, KeyOf>& set,
+    R init,
+    Reduce reduce,
+    Combine combine,
+    std::size_t threads) {
+  std::vector<R> partial(threads == 0 ? 1 : threads, init);
+  parallel_for_each_range(
+      set, threads, [&](const auto& range, std::size_t chunk) {
+        R accumulator = init;
+        for (auto it = range.begin(), end = range.end(); it != end; ++it) {
+          accumulator = reduce(std::move(accumulator), *it);
+        }
+        partial[chunk] = std::move(accumulator);
+      });
+
+  R result = std::move(init);
+  for (auto& value : partial) {
+    result = combine(std::move(result), std::move(value));
+  }
+  return result;
+}
+
+#endif
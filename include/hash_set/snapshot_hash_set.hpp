@@ -0,0 +1,94 @@
+#ifndef SNAPSHOT_HASHSET_HPP
+#define SNAPSHOT_HASHSET_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+
+// Hash set whose copies share storage. The bucket array is split into
+// fixed-size segments with reference counts, so copying (or snapshot())
+// costs O(segments) and a writer clones only the segments it modifies while
+// they are still shared. A snapshot may be read on another thread while the
+// original keeps being mutated; each individual object still needs external
+// synchronisation if it is used from several threads at once.
+//
+// Growing the table redistributes every element, so an insert that
+// crosses the load factor while snapshots are alive copies each segment
+// still shared with them: O(n) time and memory, once per doubling.
+// Between rehashes, extra memory is proportional to the segments written.
+template <typename T>
+class SnapshotHashSet {
+ public:
+  SnapshotHashSet();
+  SnapshotHashSet(const SnapshotHashSet& other);
+  SnapshotHashSet(SnapshotHashSet&& other) noexcept;
+  SnapshotHashSet(std::initializer_list<T> values);
+  ~SnapshotHashSet();
+
+  SnapshotHashSet& operator=(const SnapshotHashSet& other);
+  SnapshotHashSet& operator=(SnapshotHashSet&& other) noexcept;
+
+  SnapshotHashSet snapshot() const;
+  void insert(const T& value);
+  void erase(const T& value);
+  void clear() noexcept;
+  bool contains(const T& value) const;
+  bool empty() const noexcept;
+  std::size_t size() const noexcept;
+
+  template <typename Function>
+  void for_each(Function fn) const;
+
+ private:
+  struct Node {
+    T value;
+    Node* next;
+    Node(const T& value, Node* next = nullptr) : value(value), next(next) {
+    }
+  };
+
+  static constexpr std::size_t SEGMENT_SIZE = 64;
+  static constexpr double LOAD_FACTOR = 0.75;
+
+  struct Segment {
+    std::atomic<std::size_t> refs;
+    Node* buckets[SEGMENT_SIZE];
+
+    Segment();
+    Segment(const Segment& other);
+    ~Segment();
+
+    void destroyChains() noexcept;
+  };
+
+  Segment** m_segments;
+  std::size_t m_segmentCount;
+  std::size_t m_size;
+
+  std::size_t capacity() const noexcept;
+  std::size_t bucketIndex(const T& value) const;
+  Segment* writableSegment(std::size_t segment);
+  void rehash();
+  void releaseSegments() noexcept;
+  void shareFrom(const SnapshotHashSet& other);
+
+  static Segment* emptySegment() noexcept;
+  static void retain(Segment* segment) noexcept;
+  static void release(Segment* segment) noexcept;
+};
+
+template <typename T>
+template <typename Function>
+void SnapshotHashSet<T>::for_each(Function fn) const {
+  for (std::size_t s = 0; s < m_segmentCount; ++s) {
+    const Segment* segment = m_segments[s];
+    for (std::size_t b = 0; b < SEGMENT_SIZE; ++b) {
+      for (const Node* node = segment->buckets[b]; node != nullptr;
+           node = node->next) {
+        fn(node->value);
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef SPILLABLE_HASHSET_HPP
+#define SPILLABLE_HASHSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <hash_set/hash_set.hpp>
+#include <string>
+#include <vector>
+
+// Hash set with a memory budget for key spaces larger than RAM. Keys are
+// partitioned by hash. When the in-memory elements exceed the budget the
+// partition holding the most of them is written to a new sorted run file in
+// directory and freed. Lookups then fall back to binary search over the
+// partition's memory-mapped runs, newest first. Runs are compacted by tier:
+// once TIER_FANOUT runs of the same tier have accumulated they are merged
+// into one run of the next tier, so a key is rewritten about
+// log(spills) / log(TIER_FANOUT) times in total instead of at every spill.
+// Each run keeps a Bloom filter, so most lookups of absent keys never touch
+// it. The budget covers the buffered elements only; the filters (about
+// 1.25 bytes per spilled key) are reported by filter_bytes() and the mapped
+// runs live in the page cache.
+// directory must exist and should be dedicated to this set; the run files
+// are removed by the destructor.
+template <typename T>
+class SpillableHashSet {
+ public:
+  static constexpr std::size_t DEFAULT_PARTITIONS = 64;
+
+  SpillableHashSet(
+      std::size_t memory_budget,
+      std::string directory,
+      std::size_t partitions = DEFAULT_PARTITIONS);
+  SpillableHashSet(const SpillableHashSet& other) = delete;
+  ~SpillableHashSet();
+
+  SpillableHashSet& operator=(const SpillableHashSet& other) = delete;
+
+  // Returns false if an equal element was already present.
+  bool insert(const T& value);
+  bool contains(const T& value) const;
+  bool empty() const noexcept;
+  std::size_t size() const noexcept;
+  // Bytes of the elements buffered in memory, at most the budget.
+  std::size_t resident_bytes() const noexcept;
+  std::size_t filter_bytes() const noexcept;
+  std::size_t spilled_partitions() const noexcept;
+
+ private:
+  static constexpr std::size_t FILTER_BITS_PER_KEY = 10;
+  static constexpr std::size_t FILTER_HASHES = 4;
+  static constexpr std::size_t MIN_FILTER_BITS = 512;
+  static constexpr std::size_t TIER_FANOUT = 4;
+
+  struct Run {
+    std::string path;
+    const char* data;
+    std::size_t bytes;
+    std::size_t tier;
+    std::vector<std::uint64_t> filter;
+
+    Run();
+  };
+
+  struct Partition {
+    // Every element while the partition has never been spilled; only the
+    // ones added since the last spill afterwards.
+    HashSet<T> values;
+    // Oldest first; tiers never increase towards the back.
+    std::vector<Run> runs;
+    std::size_t bytes;
+
+    Partition();
+  };
+
+  std::vector<Partition> m_partitions;
+  std::string m_directory;
+  std::size_t m_budget;
+  std::size_t m_residentBytes;
+  std::size_t m_filterBytes;
+  std::size_t m_size;
+  std::size_t m_nextRun;
+
+  std::size_t partitionIndex(std::uint64_t mixed) const noexcept;
+  std::string runPath(std::size_t index);
+  bool find(const Partition& partition, std::uint64_t mixed, const T& value)
+      const;
+  void spill(std::size_t index);
+  void compact(std::size_t index);
+  void enforceBudget();
+  template <typename Emit>
+  Run writeRun(
+      std::size_t index,
+      std::size_t tier,
+      std::size_t records,
+      Emit emit);
+  static void addToFilter(
+      std::vector<std::uint64_t>& filter,
+      std::uint64_t mixed);
+  static bool mayContain(
+      const std::vector<std::uint64_t>& filter,
+      std::uint64_t mixed);
+  static std::size_t filterBytes(const Run& run) noexcept;
+  static void removeRun(Run& run) noexcept;
+};
+
+#endif
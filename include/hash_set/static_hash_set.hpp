@@ -0,0 +1,217 @@
+#ifndef STATIC_HASHSET_HPP
+#define STATIC_HASHSET_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <hash_set/hash_mix.hpp>
+#include <string_view>
+#include <type_traits>
+
+// Fixed set of integral or std::string_view keys whose table is computed
+// entirely at compile time. Declared constexpr, it is constant-initialized
+// into read-only data, with no static-init code and no heap.
+//
+// The layout is a perfect hash (hash and displace): keys are split into
+// small groups by hash, and each group gets a displacement chosen so that
+// every key lands in its own slot. If no displacement fits, the next seed
+// is tried. Empty slots hold a copy of the first key, so contains() hashes
+// once and makes a single comparison, without a separate occupancy check.
+//
+//   constexpr auto keywords =
+//       make_static_hash_set<std::string_view>({"if", "else", "while"});
+//   static_assert(keywords.contains("else"));
+template <typename T, std::size_t N>
+class StaticHashSet {
+  static_assert(
+      std::is_integral_v<T> || std::is_same_v<T, std::string_view>,
+      "StaticHashSet supports integral and std::string_view keys");
+
+ public:
+  // Power of two with at least twice as many slots as keys.
+  static constexpr std::size_t CAPACITY = [] {
+    std::size_t capacity = 2;
+    while (capacity < 2 * N) {
+      capacity *= 2;
+    }
+    return capacity;
+  }();
+
+  // Power of two with about two keys per group.
+  static constexpr std::size_t GROUPS = [] {
+    std::size_t groups = 1;
+    while (groups * 2 < N) {
+      groups *= 2;
+    }
+    return groups;
+  }();
+
+  constexpr explicit StaticHashSet(const T (&keys)[N])
+      : m_keys(), m_displacement(), m_seed(0), m_size(0) {
+    while (!build(keys)) {
+      ++m_seed;
+    }
+  }
+
+  constexpr bool contains(const T& key) const noexcept {
+    return m_keys[slotFor(hashKey(key, m_seed))] == key;
+  }
+
+  constexpr std::size_t size() const noexcept {
+    return m_size;
+  }
+
+  constexpr bool empty() const noexcept {
+    return m_size == 0;
+  }
+
+ private:
+  static constexpr std::uint32_t MAX_DISPLACEMENT = 1u << 12;
+
+  std::array<T, CAPACITY> m_keys;
+  std::array<std::uint32_t, GROUPS> m_displacement;
+  std::uint64_t m_seed;
+  std::size_t m_size;
+
+  static constexpr std::uint64_t hashKey(
+      const T& key,
+      std::uint64_t seed) noexcept {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      // Eight bytes per round; the shifts compile to a single load.
+      std::uint64_t hash = mix(seed ^ key.size());
+      std::size_t i = 0;
+      for (; i + 8 <= key.size(); i += 8) {
+        std::uint64_t word = 0;
+        for (std::size_t b = 0; b < 8; ++b) {
+          word |= std::uint64_t{static_cast<unsigned char>(key[i + b])}
+                  << (8 * b);
+        }
+        hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+      }
+      std::uint64_t tail = 0;
+      for (std::size_t b = 0; i + b < key.size(); ++b) {
+        tail |= std::uint64_t{static_cast<unsigned char>(key[i + b])}
+                << (8 * b);
+      }
+      return mix(hash ^ tail);
+    } else {
+      return mix(static_cast<std::uint64_t>(key) ^
+                 (seed * 0x9e3779b97f4a7c15ULL));
+    }
+  }
+
+  static constexpr std::size_t groupOf(std::uint64_t hash) noexcept {
+    return hash & (GROUPS - 1);
+  }
+
+  // Odd step, so displacements 0..CAPACITY-1 visit every slot.
+  static constexpr std::size_t probeSlot(
+      std::uint64_t hash,
+      std::uint32_t displacement) noexcept {
+    const std::uint64_t step = (hash >> 16) | 1;
+    return ((hash >> 32) + displacement * step) & (CAPACITY - 1);
+  }
+
+  constexpr std::size_t slotFor(std::uint64_t hash) const noexcept {
+    return probeSlot(hash, m_displacement[groupOf(hash)]);
+  }
+
+  // Places every key under m_seed, largest groups first; false if some
+  // group finds no displacement.
+  constexpr bool build(const T (&keys)[N]) {
+    std::array<bool, CAPACITY> used{};
+    for (T& slot : m_keys) {
+      slot = keys[0];
+    }
+    m_displacement = {};
+    m_size = 0;
+
+    std::array<std::uint64_t, N> hashes{};
+    std::array<std::size_t, GROUPS + 1> offsets{};
+    for (std::size_t k = 0; k < N; ++k) {
+      hashes[k] = hashKey(keys[k], m_seed);
+      ++offsets[groupOf(hashes[k]) + 1];
+    }
+    std::size_t largest = 0;
+    for (std::size_t g = 0; g < GROUPS; ++g) {
+      largest = offsets[g + 1] > largest ? offsets[g + 1] : largest;
+      offsets[g + 1] += offsets[g];
+    }
+    std::array<std::size_t, N> order{};
+    std::array<std::size_t, GROUPS> fill{};
+    for (std::size_t k = 0; k < N; ++k) {
+      const std::size_t g = groupOf(hashes[k]);
+      order[offsets[g] + fill[g]++] = k;
+    }
+
+    for (std::size_t count = largest; count > 0; --count) {
+      for (std::size_t g = 0; g < GROUPS; ++g) {
+        const std::size_t first = offsets[g];
+        const std::size_t last = offsets[g + 1];
+        if (last - first == count &&
+            !placeGroup(keys, hashes, order, used, first, last, g)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  constexpr bool placeGroup(
+      const T (&keys)[N],
+      const std::array<std::uint64_t, N>& hashes,
+      const std::array<std::size_t, N>& order,
+      std::array<bool, CAPACITY>& used,
+      std::size_t first,
+      std::size_t last,
+      std::size_t group) {
+    for (std::uint32_t d = 0; d < MAX_DISPLACEMENT; ++d) {
+      if (fits(keys, hashes, order, used, first, last, d)) {
+        m_displacement[group] = d;
+        for (std::size_t i = first; i < last; ++i) {
+          const std::size_t k = order[i];
+          const std::size_t slot = probeSlot(hashes[k], d);
+          if (!used[slot]) {
+            m_keys[slot] = keys[k];
+            used[slot] = true;
+            ++m_size;
+          }
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // True if the group's keys land on free, distinct slots under d.
+  // Duplicate keys share a hash, so they may share their slot.
+  constexpr bool fits(
+      const T (&keys)[N],
+      const std::array<std::uint64_t, N>& hashes,
+      const std::array<std::size_t, N>& order,
+      const std::array<bool, CAPACITY>& used,
+      std::size_t first,
+      std::size_t last,
+      std::uint32_t d) const {
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t slot = probeSlot(hashes[order[i]], d);
+      if (used[slot]) {
+        return false;
+      }
+      for (std::size_t j = first; j < i; ++j) {
+        if (probeSlot(hashes[order[j]], d) == slot &&
+            !(keys[order[j]] == keys[order[i]])) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+};
+
+template <typename T, std::size_t N>
+constexpr StaticHashSet<T, N> make_static_hash_set(const T (&keys)[N]) {
+  return StaticHashSet<T, N>(keys);
+}
+
+#endif
@@ -1,43 +1,108 @@
-#include <algorithm>
-#include <hash_set/hash_set.hpp>
-#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
 
-int main() {
-  HashSet<int> set;
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dedup/deduplicator.hpp>
+#include <dedup/line_input.hpp>
+#include <iostream>
+#include <string_view>
 
-  set.insert(1);
-  set.insert(2);
-  set.insert(3);
-  set.insert(4);
-  set.insert(5);
+namespace {
 
-  std::cout << "Size of set is: " << set.size() << std::endl;
+struct Options {
+  std::size_t threads = 1;
+  bool stats = false;
+  const char* path = nullptr;
+};
 
-  std::cout << "Set contains 3: " << std::boolalpha << set.contains(3)
-            << std::endl;
-  std::cout << "Set contains 6: " << std::boolalpha << set.contains(6)
-            << std::endl;
+void printUsage() {
+  std::cerr << "Usage: hashset-dedup [-j THREADS] [-s] [FILE]\n"
+            << "Writes the first occurrence of every line of FILE (or stdin)"
+            << " to stdout\nand the number of distinct lines to stderr.\n"
+            << "  -j THREADS  shard the set across THREADS threads\n"
+            << "  -s          also report throughput\n";
+}
 
-  std::cout << "Elements in set are: ";
-  for (const auto& element : set) {
-    std::cout << element << " ";
+bool parseOptions(int argc, char* argv[], Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg == "-j" && i + 1 < argc) {
+      options.threads = std::strtoul(argv[++i], nullptr, 10);
+      if (options.threads == 0) {
+        return false;
+      }
+    } else if (arg == "-s") {
+      options.stats = true;
+    } else if (arg == "-h" || arg == "--help") {
+      return false;
+    } else if (options.path == nullptr && (arg == "-" || arg[0] != '-')) {
+      options.path = arg == "-" ? nullptr : argv[i];
+    } else {
+      return false;
+    }
   }
-  std::cout << std::endl;
+  return true;
+}
 
-  set.erase(3);
+}  // namespace
 
-  std::cout << "Elements in set after removing 3 are: ";
-  for (auto it = set.begin(); it != set.end(); ++it) {
-    if (*it == 2) {
-      set.erase(*it);
-    } else {
-      std::cout << *it << " ";
+int main(int argc, char* argv[]) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 2;
+  }
+
+  int fd = STDIN_FILENO;
+  if (options.path != nullptr) {
+    fd = open(options.path, O_RDONLY);
+    if (fd < 0) {
+      std::cerr << "hashset-dedup: " << options.path << ": "
+                << std::strerror(errno) << std::endl;
+      return 1;
     }
   }
-  std::cout << std::endl;
 
-  set.clear();
-  std::cout << "Size of set after clearing is: " << set.size() << std::endl;
+  const auto start = std::chrono::steady_clock::now();
+  Deduplicator dedup(options.threads);
+  std::size_t bytes = 0;
+  input_status status = dedupMapped(fd, dedup, stdout, bytes);
+  if (status == input_status::not_mapped) {
+    status = dedupStream(fd, dedup, stdout, bytes);
+  }
+  const auto finish = std::chrono::steady_clock::now();
+  int error = errno;
+  if (fd != STDIN_FILENO) {
+    close(fd);
+  }
+  if (status == input_status::read_error) {
+    std::cerr << "hashset-dedup: read error: " << std::strerror(error)
+              << std::endl;
+    return 1;
+  }
+  // Output still buffered by stdio can fail here, after the last line.
+  if (status != input_status::write_error &&
+      (std::fflush(stdout) != 0 || std::ferror(stdout) != 0)) {
+    status = input_status::write_error;
+    error = errno;
+  }
+  if (status == input_status::write_error) {
+    std::cerr << "hashset-dedup: write error: " << std::strerror(error)
+              << std::endl;
+    return 1;
+  }
 
+  std::cerr << "distinct lines: " << dedup.distinct() << std::endl;
+  if (options.stats) {
+    const double seconds =
+        std::chrono::duration<double>(finish - start).count();
+    std::cerr << "bytes: " << bytes << ", seconds: " << seconds
+              << ", GB/s: " << static_cast<double>(bytes) / seconds / 1e9
+              << std::endl;
+  }
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,97 @@
+#include <cstring>
+#include <dedup/deduplicator.hpp>
+#include <functional>
+
+#include "worker_pool.hpp"
+
+Deduplicator::Shard::Shard() : arena(std::size_t{1} << 20), seen(&arena) {
+}
+
+Deduplicator::Deduplicator(std::size_t threads)
+    : m_pool(std::make_unique<WorkerPool>(threads == 0 ? 1 : threads)) {
+  const std::size_t shards = m_pool->size();
+  for (std::size_t i = 0; i < shards; ++i) {
+    m_shards.push_back(std::make_unique<Shard>());
+  }
+  m_routed.resize(shards, std::vector<std::vector<std::size_t>>(shards));
+}
+
+Deduplicator::~Deduplicator() = default;
+
+void Deduplicator::process(
+    const std::vector<std::string_view>& lines,
+    bool transient,
+    std::string& output) {
+  if (lines.empty()) {
+    return;
+  }
+  m_keep.assign(lines.size(), 0);
+  if (m_shards.size() == 1) {
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+      keepFirst(*m_shards[0], i, lines[i], transient);
+    }
+  } else {
+    // Every line is hashed once, by the worker whose slice holds it. Each
+    // shard then visits the slices in order, so the first occurrence of a
+    // line is still the one it keeps.
+    m_pool->run([&](std::size_t worker) { route(worker, lines); });
+    m_pool->run([&](std::size_t shard) {
+      for (const auto& routed : m_routed) {
+        for (const std::size_t i : routed[shard]) {
+          keepFirst(*m_shards[shard], i, lines[i], transient);
+        }
+      }
+    });
+  }
+
+  for (std::size_t i = 0; i < lines.size(); ++i) {
+    if (m_keep[i] != 0) {
+      output.append(lines[i]);
+      output.push_back('\n');
+    }
+  }
+}
+
+std::size_t Deduplicator::distinct() const noexcept {
+  std::size_t total = 0;
+  for (const auto& shard : m_shards) {
+    total += shard->seen.size();
+  }
+  return total;
+}
+
+void Deduplicator::route(
+    std::size_t worker,
+    const std::vector<std::string_view>& lines) {
+  const std::size_t workers = m_routed.size();
+  const std::size_t begin = lines.size() * worker / workers;
+  const std::size_t end = lines.size() * (worker + 1) / workers;
+  auto& routed = m_routed[worker];
+  for (auto& indices : routed) {
+    indices.clear();
+  }
+  for (std::size_t i = begin; i < end; ++i) {
+    // The shard comes from the high bits; HashSet indexes buckets with the
+    // low ones, which would otherwise be identical within a shard.
+    const std::size_t hash = std::hash<std::string_view>{}(lines[i]);
+    routed[(hash >> 40) % routed.size()].push_back(i);
+  }
+}
+
+void Deduplicator::keepFirst(
+    Shard& shard,
+    std::size_t index,
+    std::string_view line,
+    bool transient) {
+  if (!transient) {
+    m_keep[index] = shard.seen.insert(line);
+    return;
+  }
+  if (shard.seen.contains(line)) {
+    return;
+  }
+  char* copy = static_cast<char*>(shard.arena.allocate(line.size(), 1));
+  std::memcpy(copy, line.data(), line.size());
+  shard.seen.insert(std::string_view(copy, line.size()));
+  m_keep[index] = 1;
+}
@@ -0,0 +1,158 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <dedup/line_input.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t READ_SIZE = std::size_t{4} << 20;
+constexpr std::size_t BATCH_LINES = std::size_t{1} << 16;
+constexpr std::size_t OUTPUT_FLUSH = std::size_t{4} << 20;
+
+// Kept lines waiting to be written to file. Once a write has failed
+// nothing more is written and processing stops.
+struct Output {
+  std::FILE* file;
+  std::string pending;
+  bool failed;
+
+  explicit Output(std::FILE* out) : file(out), pending(), failed(false) {
+  }
+};
+
+bool flush(Output& output, bool force) {
+  if (output.failed) {
+    return false;
+  }
+  if (output.pending.size() >= OUTPUT_FLUSH ||
+      (force && !output.pending.empty())) {
+    const std::size_t size = output.pending.size();
+    output.failed =
+        std::fwrite(output.pending.data(), 1, size, output.file) != size;
+    output.pending.clear();
+  }
+  if (force && !output.failed) {
+    output.failed = std::fflush(output.file) != 0;
+  }
+  return !output.failed;
+}
+
+// Splits data into lines, handing them to dedup in batches. Returns the
+// number of bytes consumed, which stops at the last '\n' unless final, or
+// early if writing the output failed.
+std::size_t processLines(
+    std::string_view data,
+    bool final,
+    bool transient,
+    Deduplicator& dedup,
+    std::vector<std::string_view>& lines,
+    Output& output) {
+  std::size_t begin = 0;
+  while (begin < data.size()) {
+    const void* found =
+        std::memchr(data.data() + begin, '\n', data.size() - begin);
+    if (found == nullptr) {
+      if (!final) {
+        break;
+      }
+      lines.push_back(data.substr(begin));
+      begin = data.size();
+    } else {
+      const auto end = static_cast<std::size_t>(
+          static_cast<const char*>(found) - data.data());
+      lines.push_back(data.substr(begin, end - begin));
+      begin = end + 1;
+    }
+    if (lines.size() == BATCH_LINES) {
+      dedup.process(lines, transient, output.pending);
+      lines.clear();
+      if (!flush(output, false)) {
+        return begin;
+      }
+    }
+  }
+  dedup.process(lines, transient, output.pending);
+  lines.clear();
+  flush(output, false);
+  return begin;
+}
+
+}  // namespace
+
+input_status dedupMapped(
+    int fd,
+    Deduplicator& dedup,
+    std::FILE* out,
+    std::size_t& bytes) {
+  struct stat info {};
+  if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+    return input_status::not_mapped;
+  }
+  const auto size = static_cast<std::size_t>(info.st_size);
+  void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (mapped == MAP_FAILED) {
+    return input_status::not_mapped;
+  }
+  madvise(mapped, size, MADV_SEQUENTIAL);
+
+  std::vector<std::string_view> lines;
+  Output output(out);
+  processLines(
+      std::string_view(static_cast<const char*>(mapped), size),
+      true,
+      false,
+      dedup,
+      lines,
+      output);
+  flush(output, true);
+  // The set still points into the mapping, but nothing reads it any more.
+  munmap(mapped, size);
+  bytes += size;
+  return output.failed ? input_status::write_error : input_status::done;
+}
+
+input_status dedupStream(
+    int fd,
+    Deduplicator& dedup,
+    std::FILE* out,
+    std::size_t& bytes) {
+  std::vector<char> buffer(READ_SIZE);
+  std::vector<std::string_view> lines;
+  Output output(out);
+  std::size_t filled = 0;
+
+  while (true) {
+    if (filled == buffer.size()) {
+      buffer.resize(buffer.size() * 2);
+    }
+    const ssize_t got =
+        read(fd, buffer.data() + filled, buffer.size() - filled);
+    if (got < 0) {
+      return input_status::read_error;
+    }
+    bytes += static_cast<std::size_t>(got);
+    filled += static_cast<std::size_t>(got);
+    const bool final = got == 0;
+    const std::size_t consumed = processLines(
+        std::string_view(buffer.data(), filled),
+        final,
+        true,
+        dedup,
+        lines,
+        output);
+    if (output.failed) {
+      return input_status::write_error;
+    }
+    std::memmove(buffer.data(), buffer.data() + consumed, filled - consumed);
+    filled -= consumed;
+    if (final) {
+      break;
+    }
+  }
+  return flush(output, true) ? input_status::done : input_status::write_error;
+}
@@ -0,0 +1,88 @@
+#include "worker_pool.hpp"
+
+WorkerPool::WorkerPool(std::size_t workers)
+    : m_task(nullptr),
+      m_generation(0),
+      m_pending(0),
+      m_error(),
+      m_stop(false) {
+  for (std::size_t worker = 1; worker < workers; ++worker) {
+    m_threads.emplace_back([this, worker] { loop(worker); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all();
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+std::size_t WorkerPool::size() const noexcept {
+  return m_threads.size() + 1;
+}
+
+void WorkerPool::run(const std::function<void(std::size_t)>& task) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_pending = m_threads.size();
+    m_error = nullptr;
+    ++m_generation;
+  }
+  m_start.notify_all();
+
+  std::exception_ptr error;
+  try {
+    task(0);
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [this] { return m_pending == 0; });
+  m_task = nullptr;
+  if (error == nullptr) {
+    error = m_error;
+  }
+  lock.unlock();
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void WorkerPool::loop(std::size_t worker) {
+  std::size_t generation = 0;
+  while (true) {
+    const std::function<void(std::size_t)>* task = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_start.wait(
+          lock, [&] { return m_stop || m_generation != generation; });
+      if (m_stop) {
+        return;
+      }
+      generation = m_generation;
+      task = m_task;
+    }
+
+    std::exception_ptr error;
+    try {
+      (*task)(worker);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (error != nullptr && m_error == nullptr) {
+      m_error = error;
+    }
+    if (--m_pending == 0) {
+      m_done.notify_one();
+    }
+  }
+}
@@ -0,0 +1,42 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads that run the same task together, so that a task
+// issued per batch does not pay for creating and joining threads.
+class WorkerPool {
+ public:
+  explicit WorkerPool(std::size_t workers);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  std::size_t size() const noexcept;
+  // Calls task(worker) once for every worker in [0, size()) and returns
+  // when all calls have finished. The calling thread acts as worker 0. The
+  // first exception thrown by any call is rethrown here.
+  void run(const std::function<void(std::size_t)>& task);
+
+ private:
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_done;
+  const std::function<void(std::size_t)>* m_task;
+  std::size_t m_generation;
+  std::size_t m_pending;
+  std::exception_ptr m_error;
+  bool m_stop;
+
+  void loop(std::size_t worker);
+};
+
+#endif
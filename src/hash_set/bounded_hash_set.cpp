@@ -0,0 +1,184 @@
+#include <functional>
+#include <hash_set/bounded_hash_set.hpp>
+#include <string>
+
+template <typename T>
+T& BoundedHashSet<T>::Node::value() noexcept {
+  return *std::launder(reinterpret_cast<T*>(storage));
+}
+
+template <typename T>
+const T& BoundedHashSet<T>::Node::value() const noexcept {
+  return *std::launder(reinterpret_cast<const T*>(storage));
+}
+
+template <typename T>
+BoundedHashSet<T>::BoundedHashSet(std::size_t max_size, clock::duration ttl)
+    : m_data(nullptr),
+      m_capacity(1),
+      m_pool(nullptr),
+      m_free(nullptr),
+      m_oldest(nullptr),
+      m_newest(nullptr),
+      m_maxSize(max_size == 0 ? 1 : max_size),
+      m_size(0),
+      m_ttl(ttl) {
+  while (m_capacity * LOAD_FACTOR < m_maxSize) {
+    m_capacity *= 2;
+  }
+  m_data = new Node*[m_capacity]();
+  m_pool = new Node[m_maxSize];
+  for (std::size_t i = m_maxSize; i-- > 0;) {
+    m_pool[i].next = m_free;
+    m_free = &m_pool[i];
+  }
+}
+
+template <typename T>
+BoundedHashSet<T>::~BoundedHashSet() {
+  clear();
+  delete[] m_pool;
+  delete[] m_data;
+}
+
+template <typename T>
+bool BoundedHashSet<T>::insert(const T& value) {
+  return insert(value, clock::now());
+}
+
+template <typename T>
+bool BoundedHashSet<T>::insert(const T& value, clock::time_point now) {
+  for (std::size_t i = 0;
+       i < EXPIRE_BATCH && m_oldest != nullptr && expired(m_oldest, now);
+       ++i) {
+    remove(m_oldest);
+  }
+
+  if (Node* existing = find(value)) {
+    if (!expired(existing, now)) {
+      return false;
+    }
+    remove(existing);
+  }
+  if (m_size == m_maxSize) {
+    remove(m_oldest);
+  }
+
+  Node* node = m_free;
+  const std::size_t index = bucketIndex(value);
+  new (node->storage) T(value);
+  m_free = node->next;
+  node->next = m_data[index];
+  m_data[index] = node;
+  node->older = m_newest;
+  node->newer = nullptr;
+  node->inserted = now;
+  if (m_newest != nullptr) {
+    m_newest->newer = node;
+  } else {
+    m_oldest = node;
+  }
+  m_newest = node;
+  ++m_size;
+  return true;
+}
+
+template <typename T>
+bool BoundedHashSet<T>::contains(const T& value) const {
+  return contains(value, clock::now());
+}
+
+template <typename T>
+bool BoundedHashSet<T>::contains(const T& value, clock::time_point now)
+    const {
+  const Node* node = find(value);
+  return node != nullptr && !expired(node, now);
+}
+
+template <typename T>
+void BoundedHashSet<T>::erase(const T& value) {
+  if (Node* node = find(value)) {
+    remove(node);
+  }
+}
+
+template <typename T>
+void BoundedHashSet<T>::clear() noexcept {
+  while (m_oldest != nullptr) {
+    remove(m_oldest);
+  }
+}
+
+template <typename T>
+bool BoundedHashSet<T>::empty() const noexcept {
+  return m_size == 0;
+}
+
+template <typename T>
+std::size_t BoundedHashSet<T>::size() const noexcept {
+  return m_size;
+}
+
+template <typename T>
+std::size_t BoundedHashSet<T>::max_size() const noexcept {
+  return m_maxSize;
+}
+
+template <typename T>
+std::size_t BoundedHashSet<T>::bucketIndex(const T& value) const {
+  return std::hash<T>{}(value) & (m_capacity - 1);
+}
+
+template <typename T>
+typename BoundedHashSet<T>::Node* BoundedHashSet<T>::find(
+    const T& value) const {
+  for (Node* current = m_data[bucketIndex(value)]; current != nullptr;
+       current = current->next) {
+    if (current->value() == value) {
+      return current;
+    }
+  }
+  return nullptr;
+}
+
+template <typename T>
+bool BoundedHashSet<T>::expired(const Node* node, clock::time_point now)
+    const noexcept {
+  return m_ttl != clock::duration::zero() && now - node->inserted >= m_ttl;
+}
+
+// Unlinks node from its bucket and from the age list and returns its slot
+// to the free list.
+template <typename T>
+void BoundedHashSet<T>::remove(Node* node) noexcept {
+  Node** link = &m_data[bucketIndex(node->value())];
+  while (*link != node) {
+    link = &(*link)->next;
+  }
+  *link = node->next;
+
+  if (node->older != nullptr) {
+    node->older->newer = node->newer;
+  } else {
+    m_oldest = node->newer;
+  }
+  if (node->newer != nullptr) {
+    node->newer->older = node->older;
+  } else {
+    m_newest = node->older;
+  }
+
+  node->value().~T();
+  node->next = m_free;
+  m_free = node;
+  --m_size;
+}
+
+template class BoundedHashSet<int>;
+template class BoundedHashSet<std::string>;
+template class BoundedHashSet<double>;
+template class BoundedHashSet<char>;
+template class BoundedHashSet<float>;
+template class BoundedHashSet<bool>;
+template class BoundedHashSet<long>;
+template class BoundedHashSet<short>;
@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <functional>
+#include <hash_set/cuckoo_hash_set.hpp>
+#include <hash_set/hash_mix.hpp>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr std::uint64_t DEFAULT_SEED = 0x9e3779b97f4a7c15ULL;
+
+std::uint64_t nextRandom(std::uint64_t& state) noexcept {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+}  // namespace
+
+template <typename T>
+CuckooHashSet<T>::CuckooHashSet()
+    : m_buckets(new Bucket[DEFAULT_BUCKETS]()),
+      m_bucketCount(DEFAULT_BUCKETS),
+      m_size(0),
+      m_seed(DEFAULT_SEED),
+      m_random(DEFAULT_SEED),
+      m_stash(),
+      m_stashSize(0),
+      m_overflow() {
+}
+
+template <typename T>
+CuckooHashSet<T>::CuckooHashSet(const CuckooHashSet& other)
+    : m_buckets(nullptr),
+      m_bucketCount(0),
+      m_size(0),
+      m_seed(other.m_seed),
+      m_random(other.m_random),
+      m_stash(),
+      m_stashSize(0),
+      m_overflow() {
+  copyFrom(other);
+}
+
+template <typename T>
+CuckooHashSet<T>::CuckooHashSet(CuckooHashSet&& other) noexcept
+    : m_buckets(nullptr),
+      m_bucketCount(0),
+      m_size(0),
+      m_seed(other.m_seed),
+      m_random(other.m_random),
+      m_stash(),
+      m_stashSize(0),
+      m_overflow() {
+  moveFrom(std::move(other));
+}
+
+template <typename T>
+CuckooHashSet<T>::CuckooHashSet(std::initializer_list<T> values)
+    : CuckooHashSet() {
+  for (const auto& value : values) {
+    insert(value);
+  }
+}
+
+template <typename T>
+CuckooHashSet<T>::~CuckooHashSet() {
+  delete[] m_buckets;
+}
+
+template <typename T>
+CuckooHashSet<T>& CuckooHashSet<T>::operator=(const CuckooHashSet& other) {
+  if (this != &other) {
+    CuckooHashSet copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+template <typename T>
+CuckooHashSet<T>& CuckooHashSet<T>::operator=(CuckooHashSet&& other) noexcept {
+  if (this != &other) {
+    delete[] m_buckets;
+    m_buckets = nullptr;
+    moveFrom(std::move(other));
+  }
+  return *this;
+}
+
+template <typename T>
+void CuckooHashSet<T>::insert(const T& value) {
+  if (contains(value)) {
+    return;
+  }
+  if (m_size + 1 > m_bucketCount * SLOTS * LOAD_FACTOR) {
+    grow();
+  }
+  T pending(value);
+  if (!place(pending)) {
+    // At most one rebuild per insert, and none once something overflowed:
+    // that failure was not about the table's size, so growing again would
+    // not help.
+    bool placed = false;
+    if (m_overflow.empty()) {
+      grow();
+      placed = place(pending);
+    }
+    if (!placed) {
+      m_overflow.push_back(std::move(pending));
+    }
+  }
+  ++m_size;
+}
+
+template <typename T>
+void CuckooHashSet<T>::erase(const T& value) {
+  if (m_bucketCount == 0) {
+    return;
+  }
+  const std::size_t hash = std::hash<T>{}(value);
+  for (const std::size_t b : {firstBucket(hash), secondBucket(hash)}) {
+    Bucket& bucket = m_buckets[b];
+    for (std::size_t s = 0; s < SLOTS; ++s) {
+      if ((bucket.occupied & (1u << s)) && bucket.values[s] == value) {
+        bucket.occupied &= static_cast<std::uint8_t>(~(1u << s));
+        bucket.values[s] = T();
+        --m_size;
+        // The freed slot may be the home of a stashed element.
+        for (std::size_t i = 0; i < m_stashSize; ++i) {
+          const std::size_t stashed = std::hash<T>{}(m_stash[i]);
+          if ((firstBucket(stashed) == b || secondBucket(stashed) == b) &&
+              placeInBucket(bucket, m_stash[i])) {
+            m_stash[i] = std::move(m_stash[--m_stashSize]);
+            m_stash[m_stashSize] = T();
+            break;
+          }
+        }
+        return;
+      }
+    }
+  }
+  for (std::size_t i = 0; i < m_stashSize; ++i) {
+    if (m_stash[i] == value) {
+      m_stash[i] = std::move(m_stash[--m_stashSize]);
+      m_stash[m_stashSize] = T();
+      --m_size;
+      return;
+    }
+  }
+  for (auto it = m_overflow.begin(); it != m_overflow.end(); ++it) {
+    if (*it == value) {
+      m_overflow.erase(it);
+      --m_size;
+      return;
+    }
+  }
+}
+
+template <typename T>
+void CuckooHashSet<T>::clear() noexcept {
+  for (std::size_t b = 0; b < m_bucketCount; ++b) {
+    for (std::size_t s = 0; s < SLOTS; ++s) {
+      m_buckets[b].values[s] = T();
+    }
+    m_buckets[b].occupied = 0;
+  }
+  for (std::size_t i = 0; i < m_stashSize; ++i) {
+    m_stash[i] = T();
+  }
+  m_stashSize = 0;
+  m_overflow.clear();
+  m_size = 0;
+}
+
+template <typename T>
+bool CuckooHashSet<T>::contains(const T& value) const {
+  if (m_bucketCount == 0) {
+    return false;
+  }
+  const std::size_t hash = std::hash<T>{}(value);
+  if (findInBucket(m_buckets[firstBucket(hash)], value) ||
+      findInBucket(m_buckets[secondBucket(hash)], value)) {
+    return true;
+  }
+  for (std::size_t i = 0; i < m_stashSize; ++i) {
+    if (m_stash[i] == value) {
+      return true;
+    }
+  }
+  for (const T& overflowed : m_overflow) {
+    if (overflowed == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+bool CuckooHashSet<T>::empty() const noexcept {
+  return m_size == 0;
+}
+
+template <typename T>
+std::size_t CuckooHashSet<T>::size() const noexcept {
+  return m_size;
+}
+
+template <typename T>
+std::size_t CuckooHashSet<T>::bucket_count() const noexcept {
+  return m_bucketCount;
+}
+
+template <typename T>
+std::size_t CuckooHashSet<T>::firstBucket(std::size_t hash) const noexcept {
+  return mix(hash ^ m_seed) & (m_bucketCount - 1);
+}
+
+template <typename T>
+std::size_t CuckooHashSet<T>::secondBucket(std::size_t hash) const noexcept {
+  return mix(hash + m_seed * 3 + 1) & (m_bucketCount - 1);
+}
+
+template <typename T>
+bool CuckooHashSet<T>::findInBucket(const Bucket& bucket, const T& value) {
+  for (std::size_t s = 0; s < SLOTS; ++s) {
+    if ((bucket.occupied & (1u << s)) && bucket.values[s] == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+bool CuckooHashSet<T>::placeInBucket(Bucket& bucket, T& value) {
+  for (std::size_t s = 0; s < SLOTS; ++s) {
+    if (!(bucket.occupied & (1u << s))) {
+      bucket.values[s] = std::move(value);
+      bucket.occupied |= static_cast<std::uint8_t>(1u << s);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Places value, displacing residents along a random walk of bounded length.
+// On failure value holds whichever element was left without a slot.
+template <typename T>
+bool CuckooHashSet<T>::place(T& value) {
+  std::size_t hash = std::hash<T>{}(value);
+  const std::size_t first = firstBucket(hash);
+  const std::size_t second = secondBucket(hash);
+  if (placeInBucket(m_buckets[first], value) ||
+      placeInBucket(m_buckets[second], value)) {
+    return true;
+  }
+
+  std::size_t bucket = (nextRandom(m_random) & 1) != 0 ? first : second;
+  for (std::size_t i = 0; i < MAX_DISPLACEMENTS; ++i) {
+    const std::size_t slot = nextRandom(m_random) % SLOTS;
+    std::swap(value, m_buckets[bucket].values[slot]);
+    hash = std::hash<T>{}(value);
+    const std::size_t alternative = firstBucket(hash) == bucket
+        ? secondBucket(hash)
+        : firstBucket(hash);
+    if (placeInBucket(m_buckets[alternative], value)) {
+      return true;
+    }
+    bucket = alternative;
+  }
+
+  if (m_stashSize < STASH_SIZE) {
+    m_stash[m_stashSize++] = std::move(value);
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+void CuckooHashSet<T>::grow() {
+  rebuild(std::max(m_bucketCount * 2, DEFAULT_BUCKETS));
+}
+
+// Reinserts every element into a table of the given size with a new seed.
+// Elements that find no slot there overflow rather than growing it again.
+template <typename T>
+void CuckooHashSet<T>::rebuild(std::size_t buckets) {
+  CuckooHashSet next;
+  delete[] next.m_buckets;
+  next.m_buckets = nullptr;
+  next.m_bucketCount = buckets;
+  next.m_buckets = new Bucket[next.m_bucketCount]();
+  next.m_seed = mix(m_seed);
+  next.m_random = m_random;
+
+  // Elements are copied rather than moved so that *this stays intact if an
+  // allocation throws half way through.
+  for_each([&next](const T& value) {
+    T pending(value);
+    if (!next.place(pending)) {
+      next.m_overflow.push_back(std::move(pending));
+    }
+    ++next.m_size;
+  });
+  *this = std::move(next);
+}
+
+template <typename T>
+void CuckooHashSet<T>::copyFrom(const CuckooHashSet& other) {
+  m_buckets = new Bucket[other.m_bucketCount]();
+  m_bucketCount = other.m_bucketCount;
+  std::copy(other.m_buckets, other.m_buckets + other.m_bucketCount, m_buckets);
+  std::copy(other.m_stash, other.m_stash + other.m_stashSize, m_stash);
+  m_stashSize = other.m_stashSize;
+  m_overflow = other.m_overflow;
+  m_size = other.m_size;
+}
+
+template <typename T>
+void CuckooHashSet<T>::moveFrom(CuckooHashSet&& other) noexcept {
+  m_buckets = std::exchange(other.m_buckets, nullptr);
+  m_bucketCount = std::exchange(other.m_bucketCount, 0);
+  m_size = std::exchange(other.m_size, 0);
+  m_seed = other.m_seed;
+  m_random = other.m_random;
+  std::move(other.m_stash, other.m_stash + other.m_stashSize, m_stash);
+  m_stashSize = std::exchange(other.m_stashSize, 0);
+  m_overflow = std::move(other.m_overflow);
+  other.m_overflow.clear();
+}
+
+template class CuckooHashSet<int>;
+template class CuckooHashSet<std::string>;
+template class CuckooHashSet<double>;
+template class CuckooHashSet<char>;
+template class CuckooHashSet<float>;
+template class CuckooHashSet<bool>;
+template class CuckooHashSet<long>;
+template class CuckooHashSet<short>;
@@ -0,0 +1,161 @@
+#include <functional>
+#include <hash_set/fixed_hash_set.hpp>
+#include <hash_set/hash_mix.hpp>
+#include <string_view>
+
+template <typename T>
+T& FixedHashSet<T>::Node::value() noexcept {
+  return *std::launder(reinterpret_cast<T*>(storage));
+}
+
+template <typename T>
+const T& FixedHashSet<T>::Node::value() const noexcept {
+  return *std::launder(reinterpret_cast<const T*>(storage));
+}
+
+template <typename T>
+FixedHashSet<T>::FixedHashSet(
+    std::size_t max_size,
+    std::pmr::memory_resource* resource)
+    : m_resource(resource),
+      m_pool(nullptr),
+      m_data(nullptr),
+      m_capacity(bucketCount(max_size)),
+      m_free(nullptr),
+      m_maxSize(max_size),
+      m_size(0) {
+  // The pool comes first: sizeof(Node) is a multiple of alignof(Node),
+  // which is at least alignof(Node*), so the buckets after it are aligned.
+  void* storage = m_resource->allocate(storageBytes(m_maxSize), alignof(Node));
+  m_pool = static_cast<Node*>(storage);
+  m_data = reinterpret_cast<Node**>(m_pool + m_maxSize);
+  for (std::size_t i = 0; i < m_capacity; ++i) {
+    m_data[i] = nullptr;
+  }
+  for (std::size_t i = m_maxSize; i-- > 0;) {
+    m_pool[i].next = m_free;
+    m_free = &m_pool[i];
+  }
+}
+
+template <typename T>
+FixedHashSet<T>::~FixedHashSet() {
+  clear();
+  m_resource->deallocate(m_pool, storageBytes(m_maxSize), alignof(Node));
+}
+
+template <typename T>
+std::size_t FixedHashSet<T>::buffer_size(std::size_t max_size) noexcept {
+  return storageBytes(max_size) + alignof(Node) - 1;
+}
+
+template <typename T>
+typename FixedHashSet<T>::insert_result FixedHashSet<T>::insert(
+    const T& value) noexcept {
+  const std::size_t index = bucketIndex(value);
+  std::size_t chain = 0;
+  for (const Node* current = m_data[index]; current != nullptr;
+       current = current->next) {
+    if (current->value() == value) {
+      return insert_result::present;
+    }
+    ++chain;
+  }
+  if (m_free == nullptr || chain == MAX_CHAIN) {
+    return insert_result::full;
+  }
+
+  Node* node = m_free;
+  m_free = node->next;
+  new (node->storage) T(value);
+  node->next = m_data[index];
+  m_data[index] = node;
+  ++m_size;
+  return insert_result::inserted;
+}
+
+template <typename T>
+bool FixedHashSet<T>::contains(const T& value) const noexcept {
+  for (const Node* current = m_data[bucketIndex(value)]; current != nullptr;
+       current = current->next) {
+    if (current->value() == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+void FixedHashSet<T>::erase(const T& value) noexcept {
+  Node** link = &m_data[bucketIndex(value)];
+  while (*link != nullptr) {
+    Node* current = *link;
+    if (current->value() == value) {
+      *link = current->next;
+      current->value().~T();
+      current->next = m_free;
+      m_free = current;
+      --m_size;
+      return;
+    }
+    link = &current->next;
+  }
+}
+
+template <typename T>
+void FixedHashSet<T>::clear() noexcept {
+  for (std::size_t i = 0; i < m_capacity; ++i) {
+    while (m_data[i] != nullptr) {
+      Node* node = m_data[i];
+      m_data[i] = node->next;
+      node->value().~T();
+      node->next = m_free;
+      m_free = node;
+    }
+  }
+  m_size = 0;
+}
+
+template <typename T>
+bool FixedHashSet<T>::empty() const noexcept {
+  return m_size == 0;
+}
+
+template <typename T>
+std::size_t FixedHashSet<T>::size() const noexcept {
+  return m_size;
+}
+
+template <typename T>
+std::size_t FixedHashSet<T>::max_size() const noexcept {
+  return m_maxSize;
+}
+
+// Smallest power of two with at least two buckets per element.
+template <typename T>
+std::size_t FixedHashSet<T>::bucketCount(std::size_t max_size) noexcept {
+  std::size_t capacity = 1;
+  while (capacity < 2 * max_size) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+template <typename T>
+std::size_t FixedHashSet<T>::storageBytes(std::size_t max_size) noexcept {
+  return max_size * sizeof(Node) + bucketCount(max_size) * sizeof(Node*);
+}
+
+template <typename T>
+std::size_t FixedHashSet<T>::bucketIndex(const T& value) const noexcept {
+  return mix(std::hash<T>{}(value)) & (m_capacity - 1);
+}
+
+template class FixedHashSet<int>;
+template class FixedHashSet<std::string_view>;
+template class FixedHashSet<double>;
+template class FixedHashSet<char>;
+template class FixedHashSet<float>;
+template class FixedHashSet<bool>;
+template class FixedHashSet<long>;
+template class FixedHashSet<short>;
@@ -0,0 +1,118 @@
+#include <cstddef>
+#include <hash_set/hash_map.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+template <typename K, typename V>
+HashMap<K, V>::HashMap() : m_table() {
+}
+
+template <typename K, typename V>
+HashMap<K, V>::HashMap(std::pmr::memory_resource* resource)
+    : m_table(resource) {
+}
+
+template <typename K, typename V>
+HashMap<K, V>::HashMap(
+    const HashMap& other,
+    std::pmr::memory_resource* resource)
+    : m_table(other.m_table, resource) {
+}
+
+template <typename K, typename V>
+HashMap<K, V>::HashMap(
+    std::initializer_list<value_type> values,
+    std::pmr::memory_resource* resource)
+    : m_table(values, resource) {
+}
+
+template <typename K, typename V>
+bool HashMap<K, V>::operator==(const HashMap& other) const {
+  return m_table == other.m_table;
+}
+
+template <typename K, typename V>
+bool HashMap<K, V>::operator!=(const HashMap& other) const {
+  return !(*this == other);
+}
+
+template <typename K, typename V>
+bool HashMap<K, V>::insert(const value_type& value) {
+  return m_table.insert(value);
+}
+
+template <typename K, typename V>
+V& HashMap<K, V>::operator[](const K& key) {
+  return try_emplace(key).first->second;
+}
+
+template <typename K, typename V>
+V& HashMap<K, V>::at(const K& key) {
+  const iterator it = m_table.findKey(key);
+  if (it == m_table.end()) {
+    throw std::out_of_range("HashMap::at: key not found");
+  }
+  return it->second;
+}
+
+template <typename K, typename V>
+const V& HashMap<K, V>::at(const K& key) const {
+  return const_cast<HashMap&>(*this).at(key);
+}
+
+template <typename K, typename V>
+typename HashMap<K, V>::iterator HashMap<K, V>::find(const K& key) const {
+  return m_table.findKey(key);
+}
+
+template <typename K, typename V>
+bool HashMap<K, V>::contains(const K& key) const {
+  return m_table.findKey(key) != m_table.end();
+}
+
+template <typename K, typename V>
+std::size_t HashMap<K, V>::erase(const K& key) {
+  return m_table.eraseKey(key) ? 1 : 0;
+}
+
+template <typename K, typename V>
+typename HashMap<K, V>::iterator HashMap<K, V>::erase(const_iterator pos) {
+  return m_table.erase(pos);
+}
+
+template <typename K, typename V>
+void HashMap<K, V>::clear() noexcept {
+  m_table.clear();
+}
+
+template <typename K, typename V>
+bool HashMap<K, V>::empty() const noexcept {
+  return m_table.empty();
+}
+
+template <typename K, typename V>
+std::size_t HashMap<K, V>::size() const noexcept {
+  return m_table.size();
+}
+
+template <typename K, typename V>
+std::pmr::memory_resource* HashMap<K, V>::resource() const noexcept {
+  return m_table.resource();
+}
+
+template <typename K, typename V>
+typename HashMap<K, V>::iterator HashMap<K, V>::begin() const noexcept {
+  return m_table.begin();
+}
+
+template <typename K, typename V>
+typename HashMap<K, V>::iterator HashMap<K, V>::end() const noexcept {
+  return m_table.end();
+}
+
+template class HashMap<int, int>;
+template class HashMap<long, long>;
+template class HashMap<std::string, int>;
+template class HashMap<std::string, std::string>;
+template class HashMap<std::string_view, std::size_t>;
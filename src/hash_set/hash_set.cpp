@@ -1,196 +1,470 @@
 #include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <hash_set/hash_set.hpp>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-template <typename T>
-HashSet<T>::HashSet()
-    : m_data(new Node*[DEFAULT_CAPACITY]()),
-      m_capacity(DEFAULT_CAPACITY),
-      m_size(0) {
+#include "sorting.hpp"
+
+namespace {
+
+constexpr std::size_t ORDER_LOCKS = 16;
+
+// Serializes filling the sorted cache. Sets share these by address rather
+// than each carrying a mutex for a cache most of them never build.
+std::mutex& orderLock(const void* set) noexcept {
+  static std::mutex locks[ORDER_LOCKS];
+  return locks[(reinterpret_cast<std::uintptr_t>(set) >> 6) % ORDER_LOCKS];
+}
+
+}  // namespace
+
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>::HashSet() : HashSet(std::pmr::get_default_resource()) {
 }
 
-template <typename T>
-HashSet<T>::HashSet(const HashSet& other)
-    : m_data(nullptr), m_capacity(other.m_capacity), m_size(0) {
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>::HashSet(std::pmr::memory_resource* resource)
+    : m_resource(resource),
+      m_data(allocateBuckets(DEFAULT_CAPACITY)),
+      m_capacity(DEFAULT_CAPACITY),
+      m_size(0),
+      m_block(nullptr),
+      m_blockCapacity(0),
+      m_blockLive(0),
+      m_sorted(nullptr) {
+}
+
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>::HashSet(const HashSet& other)
+    : HashSet(other, std::pmr::get_default_resource()) {
+}
+
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>::HashSet(
+    const HashSet& other,
+    std::pmr::memory_resource* resource)
+    : m_resource(resource),
+      m_data(nullptr),
+      m_capacity(other.m_capacity),
+      m_size(0),
+      m_block(nullptr),
+      m_blockCapacity(0),
+      m_blockLive(0),
+      m_sorted(nullptr) {
   copyFrom(other);
 }
 
-template <typename T>
-HashSet<T>::HashSet(HashSet&& other) noexcept
-    : m_data(nullptr), m_capacity(0), m_size(0) {
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>::HashSet(HashSet&& other) noexcept
+    : m_resource(other.m_resource),
+      m_data(nullptr),
+      m_capacity(0),
+      m_size(0),
+      m_block(nullptr),
+      m_blockCapacity(0),
+      m_blockLive(0),
+      m_sorted(nullptr) {
   moveFrom(std::move(other));
 }
 
-template <typename T>
-HashSet<T>::HashSet(std::initializer_list<T> values)
-    : m_data(new Node*[DEFAULT_CAPACITY]()),
-      m_capacity(DEFAULT_CAPACITY),
-      m_size(0) {
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>::HashSet(
+    std::initializer_list<T> values,
+    std::pmr::memory_resource* resource)
+    : HashSet(resource) {
   for (const auto& value : values) {
     insert(value);
   }
 }
 
-template <typename T>
-HashSet<T>::~HashSet() {
-  clear();
-  delete[] m_data;
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>::~HashSet() {
+  release();
+  invalidateOrder();
 }
 
-template <typename T>
-void HashSet<T>::insert(const T& value) {
-  if (contains(value)) {
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::release() noexcept {
+  if (m_data == nullptr) {
     return;
   }
+  if (!isMonotonicResource()) {
+    clear();
+    deallocateBuckets(m_data, m_capacity);
+    return;
+  }
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    for (size_t i = 0; i < m_capacity; ++i) {
+      for (Node* node = m_data[i]; node != nullptr; node = node->next) {
+        node->value.~T();
+      }
+    }
+  }
+}
+
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::insert(const T& value) {
+  const key_type& key = KeyOf{}(value);
+  size_t index = bucketOf(key);
+  if (findNode(key, index) != nullptr) {
+    return false;
+  }
   if (m_size >= m_capacity * LOAD_FACTOR) {
     rehash();
+    index = bucketOf(key);
   }
-  const size_t index = std::hash<T>{}(value) % m_capacity;
-  m_data[index] = new Node(value, m_data[index]);
+  m_data[index] = createNode(value, m_data[index]);
   ++m_size;
+  invalidateOrder();
+  return true;
 }
 
-template <typename T>
-void HashSet<T>::clear() noexcept {
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::clear() noexcept {
   for (size_t i = 0; i < m_capacity; ++i) {
     Node* current = m_data[i];
     while (current != nullptr) {
       Node* next = current->next;
-      delete current;
+      destroyNode(current);
       current = next;
     }
     m_data[i] = nullptr;
   }
   m_size = 0;
+  releaseBlock();
+  invalidateOrder();
 }
 
-template <typename T>
-bool HashSet<T>::contains(const T& value) const {
-  const size_t index = std::hash<T>{}(value) % m_capacity;
-  Node* current = m_data[index];
-  while (current != nullptr) {
-    if (current->value == value) {
-      return true;
-    }
-    current = current->next;
-  }
-  return false;
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::contains(const T& value) const {
+  const key_type& key = KeyOf{}(value);
+  return findNode(key, bucketOf(key)) != nullptr;
 }
 
-template <typename T>
-bool HashSet<T>::empty() const noexcept {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::empty() const noexcept {
   return m_size == 0;
 }
 
-template <typename T>
-void HashSet<T>::erase(const T& value) {
-  const size_t index = std::hash<T>{}(value) % m_capacity;
-  Node* current = m_data[index];
-  Node* previous = nullptr;
-  while (current != nullptr) {
-    if (current->value == value) {
-      if (previous != nullptr) {
-        previous->next = current->next;
-      } else {
-        m_data[index] = current->next;
-      }
-      delete current;
-      current = nullptr;
-      --m_size;
-      return;
-    }
-    previous = current;
-    current = current->next;
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::erase(const T& value) {
+  eraseKey(KeyOf{}(value));
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::erase(
+    const_iterator pos) {
+  iterator next(pos);
+  ++next;
+
+  Node* target = pos.m_node;
+  Node** link = &m_data[pos.m_index];
+  while (*link != target) {
+    link = &(*link)->next;
   }
+  *link = target->next;
+  destroyNode(target);
+  --m_size;
+  invalidateOrder();
+  return next;
 }
 
-template <typename T>
-size_t HashSet<T>::size() const noexcept {
+template <typename T, typename KeyOf>
+size_t HashSet<T, KeyOf>::size() const noexcept {
   return m_size;
 }
 
-template <typename T>
-void HashSet<T>::rehash() {
-  size_t new_capacity = m_capacity * 2;
-  Node** new_data = new Node*[new_capacity]();
-  size_t new_size = 0;
+template <typename T, typename KeyOf>
+std::pmr::memory_resource* HashSet<T, KeyOf>::resource() const noexcept {
+  return m_resource;
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::Node* HashSet<T, KeyOf>::createNode(
+    const T& value,
+    Node* next) {
+  void* memory = m_resource->allocate(sizeof(Node), alignof(Node));
+  try {
+    return new (memory) Node(value, next);
+  } catch (...) {
+    m_resource->deallocate(memory, sizeof(Node), alignof(Node));
+    throw;
+  }
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::Node* HashSet<T, KeyOf>::createNode(
+    T&& value,
+    Node* next) {
+  void* memory = m_resource->allocate(sizeof(Node), alignof(Node));
+  try {
+    return new (memory) Node(std::move(value), next);
+  } catch (...) {
+    m_resource->deallocate(memory, sizeof(Node), alignof(Node));
+    throw;
+  }
+}
+
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::destroyNode(Node* node) noexcept {
+  node->~Node();
+  // Nodes cloned into the contiguous block are returned all at once, when
+  // the last of them is destroyed.
+  if (!isBlockNode(node)) {
+    m_resource->deallocate(node, sizeof(Node), alignof(Node));
+  } else if (--m_blockLive == 0) {
+    releaseBlock();
+  }
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::Node* HashSet<T, KeyOf>::constructNode(
+    Node* slot,
+    const T& value) {
+  Node* node = new (slot) Node(value);
+  ++m_blockLive;
+  return node;
+}
+
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::allocateBlock(size_t count) {
+  m_block = static_cast<Node*>(
+      m_resource->allocate(count * sizeof(Node), alignof(Node)));
+  m_blockCapacity = count;
+}
+
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::releaseBlock() noexcept {
+  if (m_block != nullptr) {
+    m_resource->deallocate(
+        m_block, m_blockCapacity * sizeof(Node), alignof(Node));
+    m_block = nullptr;
+    m_blockCapacity = 0;
+    m_blockLive = 0;
+  }
+}
+
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::isBlockNode(const Node* node) const noexcept {
+  return m_block != nullptr &&
+      std::greater_equal<const Node*>{}(node, m_block) &&
+      std::less<const Node*>{}(node, m_block + m_blockCapacity);
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::Node** HashSet<T, KeyOf>::allocateBuckets(
+    size_t capacity) {
+  Node** data = static_cast<Node**>(
+      m_resource->allocate(capacity * sizeof(Node*), alignof(Node*)));
+  std::uninitialized_fill_n(data, capacity, nullptr);
+  return data;
+}
+
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::deallocateBuckets(
+    Node** data,
+    size_t capacity) noexcept {
+  m_resource->deallocate(data, capacity * sizeof(Node*), alignof(Node*));
+}
+
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::isMonotonicResource() const noexcept {
+  return dynamic_cast<std::pmr::monotonic_buffer_resource*>(m_resource) !=
+      nullptr;
+}
+
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::rehash() {
+  const size_t new_capacity = m_capacity * 2;
+  Node** new_data = allocateBuckets(new_capacity);
 
   for (size_t i = 0; i < m_capacity; ++i) {
     Node* node = m_data[i];
     while (node != nullptr) {
-      size_t new_index = std::hash<T>{}(node->value) % new_capacity;
-      Node* new_node = new_data[new_index];
-      new_data[new_index] = new Node(node->value, new_node);
-      ++new_size;
-      node = node->next;
+      Node* next = node->next;
+      const size_t new_index =
+          std::hash<key_type>{}(KeyOf{}(node->value)) & (new_capacity - 1);
+      node->next = new_data[new_index];
+      new_data[new_index] = node;
+      node = next;
     }
   }
 
-  clear();
+  deallocateBuckets(m_data, m_capacity);
   m_data = new_data;
   m_capacity = new_capacity;
-  m_size = new_size;
 }
 
-template <typename T>
-void HashSet<T>::copyFrom(const HashSet& other) {
-  m_data = new Node*[other.m_capacity]();
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::copyFrom(const HashSet& other) {
+  m_data = allocateBuckets(other.m_capacity);
   m_capacity = other.m_capacity;
-  m_size = other.m_size;
+  m_size = 0;
+  invalidateOrder();
+  if (other.m_size == 0) {
+    return;
+  }
+
+  try {
+    allocateBlock(other.m_size);
+    for (size_t i = 0; i < other.m_capacity; ++i) {
+      Node** node_ptr = &m_data[i];
+      for (Node* other_node = other.m_data[i]; other_node != nullptr;
+           other_node = other_node->next) {
+        *node_ptr = constructNode(m_block + m_size, other_node->value);
+        node_ptr = &((*node_ptr)->next);
+        ++m_size;
+      }
+    }
+  } catch (...) {
+    clear();
+    deallocateBuckets(m_data, m_capacity);
+    m_data = nullptr;
+    throw;
+  }
+}
+
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::assignFrom(const HashSet& other) {
+  // Unlink every node into a spare list; their storage and, for types like
+  // std::string, their value buffers are reused for the incoming elements.
+  // Elements that cannot be assigned, such as HashMap's pairs with a const
+  // key, are destroyed right away instead. That also returns an old copy
+  // block, so the incoming elements are cloned into a fresh one.
+  constexpr bool reuse = std::is_copy_assignable_v<T>;
+  Node* spare = nullptr;
+  size_t spare_count = reuse ? m_size : 0;
+  for (size_t i = 0; i < m_capacity; ++i) {
+    while (m_data[i] != nullptr) {
+      Node* node = m_data[i];
+      m_data[i] = node->next;
+      if constexpr (reuse) {
+        node->next = spare;
+        spare = node;
+      } else {
+        destroyNode(node);
+      }
+    }
+  }
+  m_size = 0;
+  invalidateOrder();
+
+  try {
+    if (m_capacity != other.m_capacity) {
+      Node** data = allocateBuckets(other.m_capacity);
+      // A moved-from set has no bucket array to return.
+      if (m_data != nullptr) {
+        deallocateBuckets(m_data, m_capacity);
+      }
+      m_data = data;
+      m_capacity = other.m_capacity;
+    }
 
-  for (size_t i = 0; i < other.m_capacity; ++i) {
-    Node* other_node = other.m_data[i];
-    Node** node_ptr = &m_data[i];
-    while (other_node != nullptr) {
-      *node_ptr = new Node(other_node->value);
-      node_ptr = &((*node_ptr)->next);
-      other_node = other_node->next;
+    // Only a block allocated here has free slots; an older one is full.
+    const bool fresh_block = m_block == nullptr && other.m_size > spare_count;
+    size_t block_used = 0;
+    if (fresh_block) {
+      allocateBlock(other.m_size - spare_count);
     }
+
+    for (size_t i = 0; i < other.m_capacity; ++i) {
+      Node** node_ptr = &m_data[i];
+      for (Node* other_node = other.m_data[i]; other_node != nullptr;
+           other_node = other_node->next) {
+        Node* node = nullptr;
+        if constexpr (reuse) {
+          if (spare != nullptr) {
+            spare->value = other_node->value;
+            node = spare;
+            spare = spare->next;
+            node->next = nullptr;
+          }
+        }
+        if (node == nullptr && fresh_block && block_used < m_blockCapacity) {
+          node = constructNode(m_block + block_used, other_node->value);
+          ++block_used;
+        } else if (node == nullptr) {
+          node = createNode(other_node->value);
+        }
+        *node_ptr = node;
+        node_ptr = &node->next;
+        ++m_size;
+      }
+    }
+  } catch (...) {
+    while (spare != nullptr) {
+      Node* next = spare->next;
+      destroyNode(spare);
+      spare = next;
+    }
+    throw;
+  }
+
+  while (spare != nullptr) {
+    Node* next = spare->next;
+    destroyNode(spare);
+    spare = next;
   }
 }
 
-template <typename T>
-void HashSet<T>::moveFrom(HashSet&& other) noexcept {
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::moveFrom(HashSet&& other) noexcept {
   m_data = other.m_data;
   m_capacity = other.m_capacity;
   m_size = other.m_size;
+  m_block = other.m_block;
+  m_blockCapacity = other.m_blockCapacity;
+  m_blockLive = other.m_blockLive;
 
   other.m_data = nullptr;
   other.m_capacity = 0;
   other.m_size = 0;
+  other.m_block = nullptr;
+  other.m_blockCapacity = 0;
+  other.m_blockLive = 0;
+  invalidateOrder();
+  other.invalidateOrder();
 }
 
-template <typename T>
-HashSet<T>& HashSet<T>::operator=(const HashSet& other) {
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>& HashSet<T, KeyOf>::operator=(const HashSet& other) {
   if (this != &other) {
-    clear();
-    delete[] m_data;
-    m_data = nullptr;
-    copyFrom(other);
+    assignFrom(other);
   }
   return *this;
 }
 
-template <typename T>
-HashSet<T>& HashSet<T>::operator=(HashSet&& other) noexcept {
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>& HashSet<T, KeyOf>::operator=(HashSet&& other) noexcept {
   if (this != &other) {
-    clear();
-    delete[] m_data;
+    release();
     m_data = nullptr;
     m_capacity = 0;
+    m_resource = other.m_resource;
     moveFrom(std::move(other));
   }
   return *this;
 }
 
-template <typename T>
-bool HashSet<T>::operator==(const HashSet<T>& other) const {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::operator==(const HashSet<T, KeyOf>& other) const {
   if (m_size != other.m_size) {
     return false;
   }
 
   for (const auto& value : other) {
-    if (!contains(value)) {
+    const key_type& key = KeyOf{}(value);
+    const Node* node = findNode(key, bucketOf(key));
+    if (node == nullptr || !(node->value == value)) {
       return false;
     }
   }
@@ -198,107 +472,255 @@ bool HashSet<T>::operator==(const HashSet<T>& other) const {
   return true;
 }
 
-template <typename T>
-bool HashSet<T>::operator!=(const HashSet<T>& other) const {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::operator!=(const HashSet<T, KeyOf>& other) const {
   return !(*this == other);
 }
 
-template <typename T>
-bool HashSet<T>::operator<(const HashSet<T>& other) const {
-  auto it1 = begin();
-  auto it2 = other.begin();
-
-  while (it1 != end() && it2 != other.end()) {
-    if (*it1 < *it2) {
-      return true;
-    } else if (*it2 < *it1) {
-      return false;
-    }
-    ++it1;
-    ++it2;
-  }
-
-  return it1 == end() && it2 != other.end();
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::operator<(const HashSet<T, KeyOf>& other) const {
+  const std::vector<T>& lhs = ordered_view();
+  const std::vector<T>& rhs = other.ordered_view();
+  return std::lexicographical_compare(
+      lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <typename T>
-bool HashSet<T>::operator>(const HashSet<T>& other) const {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::operator>(const HashSet<T, KeyOf>& other) const {
   return other < *this;
 }
 
-template <typename T>
-bool HashSet<T>::operator<=(const HashSet<T>& other) const {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::operator<=(const HashSet<T, KeyOf>& other) const {
   return !(other < *this);
 }
 
-template <typename T>
-bool HashSet<T>::operator>=(const HashSet<T>& other) const {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::operator>=(const HashSet<T, KeyOf>& other) const {
   return !(*this < other);
 }
 
-template <typename T>
-typename HashSet<T>::iterator HashSet<T>::begin() noexcept {
-  size_t index = 0;
-  while (index < m_capacity && m_data[index] == nullptr) {
-    ++index;
+template <typename T, typename KeyOf>
+const std::vector<T>& HashSet<T, KeyOf>::ordered_view() const {
+  if (const std::vector<T>* cached = m_sorted.load(std::memory_order_acquire)) {
+    return *cached;
+  }
+  std::lock_guard<std::mutex> lock(orderLock(this));
+  if (const std::vector<T>* cached = m_sorted.load(std::memory_order_relaxed)) {
+    return *cached;
   }
-  if (index < m_capacity) {
-    return iterator(m_data, m_capacity, index);
+  auto sorted = std::make_unique<std::vector<T>>();
+  sorted->reserve(m_size);
+  if constexpr (std::is_same_v<T, bool>) {
+    // std::vector<bool> has no data() to sort, and at most two values.
+    sorted->assign(contains(false) ? 1 : 0, false);
+    sorted->resize(m_size, true);
+  } else if constexpr (std::is_integral_v<T>) {
+    sorted->assign(begin(), end());
+    radixSort(sorted->data(), sorted->size());
+  } else if constexpr (std::is_move_assignable_v<T>) {
+    sorted->assign(begin(), end());
+    parallelSort(sorted->begin(), sorted->end(), std::less<T>());
   } else {
-    return end();
+    // Elements such as HashMap's pairs cannot be moved around by a sort;
+    // sort pointers to them and copy in order.
+    std::vector<const T*> order;
+    order.reserve(m_size);
+    for (const T& value : *this) {
+      order.push_back(&value);
+    }
+    parallelSort(
+        order.begin(), order.end(), [](const T* lhs, const T* rhs) {
+          return *lhs < *rhs;
+        });
+    for (const T* value : order) {
+      sorted->push_back(*value);
+    }
   }
+  m_sorted.store(sorted.get(), std::memory_order_release);
+  return *sorted.release();
 }
 
-template <typename T>
-typename HashSet<T>::iterator HashSet<T>::begin() const noexcept {
-  size_t index = 0;
-  while (index < m_capacity && m_data[index] == nullptr) {
-    ++index;
+template <typename T, typename KeyOf>
+std::vector<T> HashSet<T, KeyOf>::to_sorted_vector() const {
+  return ordered_view();
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::begin() noexcept {
+  return firstFrom(0);
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::begin() const noexcept {
+  return firstFrom(0);
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::end() noexcept {
+  return iterator(m_data, m_capacity, m_capacity);
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::end() const noexcept {
+  return iterator(m_data, m_capacity, m_capacity);
+}
+
+template <typename T, typename KeyOf>
+std::vector<typename HashSet<T, KeyOf>::bucket_range>
+HashSet<T, KeyOf>::partition(size_t chunks) const {
+  std::vector<bucket_range> ranges;
+  if (chunks == 0 || m_capacity == 0) {
+    return ranges;
   }
-  if (index < m_capacity) {
-    return iterator(m_data, m_capacity, index);
-  } else {
+  chunks = std::min(chunks, m_capacity);
+  ranges.reserve(chunks);
+  for (size_t i = 0; i < chunks; ++i) {
+    ranges.push_back(bucket_range(
+        this, m_capacity * i / chunks, m_capacity * (i + 1) / chunks));
+  }
+  return ranges;
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::firstFrom(
+    size_t bucket) const noexcept {
+  while (bucket < m_capacity && m_data[bucket] == nullptr) {
+    ++bucket;
+  }
+  return iterator(m_data, m_capacity, bucket);
+}
+
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::invalidateOrder() noexcept {
+  if (std::vector<T>* cached = m_sorted.load(std::memory_order_relaxed)) {
+    m_sorted.store(nullptr, std::memory_order_relaxed);
+    delete cached;
+  }
+}
+
+template <typename T, typename KeyOf>
+size_t HashSet<T, KeyOf>::bucketOf(const key_type& key) const {
+  return std::hash<key_type>{}(key) & (m_capacity - 1);
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::Node* HashSet<T, KeyOf>::findNode(
+    const key_type& key,
+    size_t bucket) const {
+  Node* current = m_data[bucket];
+  while (current != nullptr && !(KeyOf{}(current->value) == key)) {
+    current = current->next;
+  }
+  return current;
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::iteratorAt(
+    Node* node,
+    size_t bucket) const noexcept {
+  if (node == nullptr) {
     return end();
   }
+  iterator it(m_data, m_capacity, bucket);
+  it.m_node = node;
+  return it;
 }
 
-template <typename T>
-typename HashSet<T>::iterator HashSet<T>::end() noexcept {
-  return iterator(m_data, m_capacity, m_capacity);
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::findKey(
+    const key_type& key) const {
+  const size_t bucket = bucketOf(key);
+  return iteratorAt(findNode(key, bucket), bucket);
 }
 
-template <typename T>
-typename HashSet<T>::iterator HashSet<T>::end() const noexcept {
-  return iterator(m_data, m_capacity, m_capacity);
+// The caller guarantees that no element with value's key is present and
+// passes the key's bucket from the lookup that established it.
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::insertUnique(
+    T&& value,
+    size_t bucket) {
+  if (m_size >= m_capacity * LOAD_FACTOR) {
+    rehash();
+    bucket = bucketOf(KeyOf{}(value));
+  }
+  m_data[bucket] = createNode(std::move(value), m_data[bucket]);
+  ++m_size;
+  invalidateOrder();
+  return iterator(m_data, m_capacity, bucket);
+}
+
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::eraseKey(const key_type& key) {
+  Node** link = &m_data[bucketOf(key)];
+  while (*link != nullptr) {
+    Node* current = *link;
+    if (KeyOf{}(current->value) == key) {
+      *link = current->next;
+      destroyNode(current);
+      --m_size;
+      invalidateOrder();
+      return true;
+    }
+    link = &current->next;
+  }
+  return false;
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::bucket_range::begin()
+    const noexcept {
+  return m_set->firstFrom(m_first);
+}
+
+// The first element at or after the next range; iterator equality only
+// looks at the node, so this stops iteration exactly at the boundary.
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::bucket_range::end()
+    const noexcept {
+  return m_set->firstFrom(m_last);
 }
 
-template <typename T>
-typename HashSet<T>::iterator::reference HashSet<T>::iterator::operator*()
-    const {
+template <typename T, typename KeyOf>
+size_t HashSet<T, KeyOf>::bucket_range::first_bucket() const noexcept {
+  return m_first;
+}
+
+template <typename T, typename KeyOf>
+size_t HashSet<T, KeyOf>::bucket_range::last_bucket() const noexcept {
+  return m_last;
+}
+
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator::reference
+HashSet<T, KeyOf>::iterator::operator*() const {
   return m_node->value;
 }
 
-template <typename T>
-typename HashSet<T>::iterator::pointer HashSet<T>::iterator::operator->()
-    const {
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator::pointer
+HashSet<T, KeyOf>::iterator::operator->() const {
   return &m_node->value;
 }
 
-template <typename T>
-typename HashSet<T>::iterator& HashSet<T>::iterator::operator++() {
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator&
+HashSet<T, KeyOf>::iterator::operator++() {
   findNextNode();
   return *this;
 }
 
-template <typename T>
-typename HashSet<T>::iterator HashSet<T>::iterator::operator++(int) {
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::iterator::operator++(
+    int) {
   iterator temp(std::move(*this));
   ++(*this);
   return temp;
 }
 
-template <typename T>
-typename HashSet<T>::iterator& HashSet<T>::iterator::operator--() {
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator&
+HashSet<T, KeyOf>::iterator::operator--() {
   if (m_node != nullptr) {
     Node* tmp = m_node;
     m_node = m_data[m_index];
@@ -326,21 +748,19 @@ typename HashSet<T>::iterator& HashSet<T>::iterator::operator--() {
   return *this;
 }
 
-template <typename T>
-typename HashSet<T>::iterator HashSet<T>::iterator::operator--(int) {
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::iterator::operator--(
+    int) {
   iterator tmp = *this;
   --(*this);
   return tmp;
 }
 
-template <typename T>
-void HashSet<T>::iterator::findNextNode() {
-  m_node = m_data[m_index];
-  if (m_node != nullptr) {
-    if (m_node->next != nullptr) {
-      m_node = m_node->next;
-      return;
-    }
+template <typename T, typename KeyOf>
+void HashSet<T, KeyOf>::iterator::findNextNode() {
+  if (m_node != nullptr && m_node->next != nullptr) {
+    m_node = m_node->next;
+    return;
   }
   for (std::size_t i = m_index + 1; i < m_capacity; ++i) {
     if (m_data[i] != nullptr) {
@@ -353,13 +773,13 @@ void HashSet<T>::iterator::findNextNode() {
   m_index = m_capacity;
 }
 
-template <typename T>
-HashSet<T>::iterator::iterator() noexcept
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>::iterator::iterator() noexcept
     : m_data(nullptr), m_capacity(0), m_index(0), m_node(nullptr) {
 }
 
-template <typename T>
-HashSet<T>::iterator::iterator(
+template <typename T, typename KeyOf>
+HashSet<T, KeyOf>::iterator::iterator(
     Node** data,
     std::size_t capacity,
     std::size_t index) noexcept
@@ -369,24 +789,24 @@ HashSet<T>::iterator::iterator(
   }
 }
 
-template <typename T>
-typename HashSet<T>::iterator HashSet<T>::iterator::operator+(
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::iterator::operator+(
     difference_type n) {
   iterator result(*this);
   result += n;
   return result;
 }
 
-template <typename T>
-typename HashSet<T>::iterator HashSet<T>::iterator::operator-(
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator HashSet<T, KeyOf>::iterator::operator-(
     difference_type n) {
   iterator result(*this);
   result -= n;
   return result;
 }
 
-template <typename T>
-typename HashSet<T>::iterator& HashSet<T>::iterator::operator-=(
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator& HashSet<T, KeyOf>::iterator::operator-=(
     difference_type n) {
   for (difference_type i = 0; i < n; ++i) {
     --(*this);
@@ -394,8 +814,8 @@ typename HashSet<T>::iterator& HashSet<T>::iterator::operator-=(
   return *this;
 }
 
-template <typename T>
-typename HashSet<T>::iterator& HashSet<T>::iterator::operator+=(
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator& HashSet<T, KeyOf>::iterator::operator+=(
     difference_type n) {
   for (difference_type i = 0; i < n; ++i) {
     ++(*this);
@@ -403,41 +823,47 @@ typename HashSet<T>::iterator& HashSet<T>::iterator::operator+=(
   return *this;
 }
 
-template <typename T>
-bool HashSet<T>::iterator::operator==(const iterator& other) const noexcept {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::iterator::operator==(
+    const iterator& other) const noexcept {
   return m_node == other.m_node;
 }
 
-template <typename T>
-bool HashSet<T>::iterator::operator!=(const iterator& other) const noexcept {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::iterator::operator!=(
+    const iterator& other) const noexcept {
   return !(*this == other);
 }
 
-template <typename T>
-bool HashSet<T>::iterator::operator<(const iterator& other) const noexcept {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::iterator::operator<(
+    const iterator& other) const noexcept {
   return m_data == other.m_data && m_index == other.m_index &&
       m_node < other.m_node;
 }
-template <typename T>
-bool HashSet<T>::iterator::operator>(const iterator& other) const noexcept {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::iterator::operator>(
+    const iterator& other) const noexcept {
   return m_data == other.m_data && m_index == other.m_index &&
       m_node > other.m_node;
 }
 
-template <typename T>
-bool HashSet<T>::iterator::operator<=(const iterator& other) const noexcept {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::iterator::operator<=(
+    const iterator& other) const noexcept {
   return m_data == other.m_data && m_index == other.m_index &&
       m_node <= other.m_node;
 }
 
-template <typename T>
-bool HashSet<T>::iterator::operator>=(const iterator& other) const noexcept {
+template <typename T, typename KeyOf>
+bool HashSet<T, KeyOf>::iterator::operator>=(
+    const iterator& other) const noexcept {
   return m_data == other.m_data && m_index == other.m_index &&
       m_node >= other.m_node;
 }
 
-template <typename T>
-typename HashSet<T>::iterator& HashSet<T>::iterator::operator=(
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator& HashSet<T, KeyOf>::iterator::operator=(
     const iterator& other) {
   if (this != &other) {
     m_data = other.m_data;
@@ -448,17 +874,24 @@ typename HashSet<T>::iterator& HashSet<T>::iterator::operator=(
   return *this;
 }
 
-template <typename T>
-typename HashSet<T>::iterator::difference_type HashSet<T>::iterator::operator-(
-    const iterator& other) const {
+template <typename T, typename KeyOf>
+typename HashSet<T, KeyOf>::iterator::difference_type
+HashSet<T, KeyOf>::iterator::operator-(const iterator& other) const {
   return m_index - other.m_index;
 }
 
 template class HashSet<int>;
 template class HashSet<std::string>;
+template class HashSet<std::string_view>;
 template class HashSet<double>;
 template class HashSet<char>;
 template class HashSet<float>;
 template class HashSet<bool>;
 template class HashSet<long>;
-template class HashSet<short>;
\ No newline at end of file
+template class HashSet<short>;
+// Element types of the HashMap instantiations in hash_map.cpp.
+template class HashSet<std::pair<const int, int>, FirstKey>;
+template class HashSet<std::pair<const long, long>, FirstKey>;
+template class HashSet<std::pair<const std::string, int>, FirstKey>;
+template class HashSet<std::pair<const std::string, std::string>, FirstKey>;
+template class HashSet<std::pair<const std::string_view, size_t>, FirstKey>;
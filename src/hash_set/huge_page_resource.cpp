@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <hash_set/huge_page_resource.hpp>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+std::size_t roundToHugePages(std::size_t bytes) {
+  constexpr std::size_t page = HugePageResource::HUGE_PAGE_SIZE;
+  return (bytes + page - 1) / page * page;
+}
+
+}  // namespace
+
+HugePageResource::HugePageResource(
+    std::size_t threshold,
+    std::pmr::memory_resource* upstream) noexcept
+    : m_threshold(threshold), m_upstream(upstream) {
+}
+
+std::size_t HugePageResource::threshold() const noexcept {
+  return m_threshold;
+}
+
+std::pmr::memory_resource* HugePageResource::upstream() const noexcept {
+  return m_upstream;
+}
+
+void* HugePageResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+#if defined(__linux__)
+  if (bytes >= m_threshold && alignment <= HUGE_PAGE_SIZE) {
+    const std::size_t length = roundToHugePages(bytes);
+    // Over-map by one huge page so the region can be trimmed to a 2 MiB
+    // boundary; THP only backs aligned extents.
+    const std::size_t mapped_length = length + HUGE_PAGE_SIZE;
+    void* mapped = mmap(
+        nullptr,
+        mapped_length,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (mapped == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+
+    char* begin = static_cast<char*>(mapped);
+    const auto address = reinterpret_cast<std::uintptr_t>(begin);
+    char* aligned = begin + (HUGE_PAGE_SIZE - address % HUGE_PAGE_SIZE) %
+            HUGE_PAGE_SIZE;
+    if (aligned != begin) {
+      munmap(begin, static_cast<std::size_t>(aligned - begin));
+    }
+    char* tail = aligned + length;
+    const std::size_t tail_length =
+        static_cast<std::size_t>(begin + mapped_length - tail);
+    if (tail_length != 0) {
+      munmap(tail, tail_length);
+    }
+
+    madvise(aligned, length, MADV_HUGEPAGE);
+    return aligned;
+  }
+#endif
+  return m_upstream->allocate(bytes, alignment);
+}
+
+void HugePageResource::do_deallocate(
+    void* p,
+    std::size_t bytes,
+    std::size_t alignment) {
+#if defined(__linux__)
+  if (bytes >= m_threshold && alignment <= HUGE_PAGE_SIZE) {
+    munmap(p, roundToHugePages(bytes));
+    return;
+  }
+#endif
+  m_upstream->deallocate(p, bytes, alignment);
+}
+
+bool HugePageResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
@@ -0,0 +1,328 @@
+#include <functional>
+#include <hash_set/snapshot_hash_set.hpp>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+template <typename T>
+SnapshotHashSet<T>::Segment::Segment() : refs(1), buckets() {
+}
+
+template <typename T>
+SnapshotHashSet<T>::Segment::Segment(const Segment& other)
+    : refs(1), buckets() {
+  try {
+    for (std::size_t i = 0; i < SEGMENT_SIZE; ++i) {
+      Node** node_ptr = &buckets[i];
+      for (Node* other_node = other.buckets[i]; other_node != nullptr;
+           other_node = other_node->next) {
+        *node_ptr = new Node(other_node->value);
+        node_ptr = &(*node_ptr)->next;
+      }
+    }
+  } catch (...) {
+    destroyChains();
+    throw;
+  }
+}
+
+template <typename T>
+SnapshotHashSet<T>::Segment::~Segment() {
+  destroyChains();
+}
+
+template <typename T>
+void SnapshotHashSet<T>::Segment::destroyChains() noexcept {
+  for (std::size_t i = 0; i < SEGMENT_SIZE; ++i) {
+    Node* current = buckets[i];
+    while (current != nullptr) {
+      Node* next = current->next;
+      delete current;
+      current = next;
+    }
+    buckets[i] = nullptr;
+  }
+}
+
+template <typename T>
+SnapshotHashSet<T>::SnapshotHashSet()
+    : m_segments(new Segment*[1]{new Segment()}),
+      m_segmentCount(1),
+      m_size(0) {
+}
+
+template <typename T>
+SnapshotHashSet<T>::SnapshotHashSet(const SnapshotHashSet& other)
+    : m_segments(nullptr), m_segmentCount(0), m_size(0) {
+  shareFrom(other);
+}
+
+template <typename T>
+SnapshotHashSet<T>::SnapshotHashSet(SnapshotHashSet&& other) noexcept
+    : m_segments(other.m_segments),
+      m_segmentCount(other.m_segmentCount),
+      m_size(other.m_size) {
+  other.m_segments = nullptr;
+  other.m_segmentCount = 0;
+  other.m_size = 0;
+}
+
+template <typename T>
+SnapshotHashSet<T>::SnapshotHashSet(std::initializer_list<T> values)
+    : SnapshotHashSet() {
+  for (const auto& value : values) {
+    insert(value);
+  }
+}
+
+template <typename T>
+SnapshotHashSet<T>::~SnapshotHashSet() {
+  releaseSegments();
+}
+
+template <typename T>
+SnapshotHashSet<T>& SnapshotHashSet<T>::operator=(
+    const SnapshotHashSet& other) {
+  if (this != &other) {
+    SnapshotHashSet copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+template <typename T>
+SnapshotHashSet<T>& SnapshotHashSet<T>::operator=(
+    SnapshotHashSet&& other) noexcept {
+  if (this != &other) {
+    releaseSegments();
+    m_segments = std::exchange(other.m_segments, nullptr);
+    m_segmentCount = std::exchange(other.m_segmentCount, 0);
+    m_size = std::exchange(other.m_size, 0);
+  }
+  return *this;
+}
+
+template <typename T>
+SnapshotHashSet<T> SnapshotHashSet<T>::snapshot() const {
+  return SnapshotHashSet(*this);
+}
+
+template <typename T>
+void SnapshotHashSet<T>::insert(const T& value) {
+  if (contains(value)) {
+    return;
+  }
+  if (m_size >= capacity() * LOAD_FACTOR) {
+    rehash();
+  }
+  const std::size_t index = bucketIndex(value);
+  Segment* segment = writableSegment(index / SEGMENT_SIZE);
+  Node*& head = segment->buckets[index % SEGMENT_SIZE];
+  head = new Node(value, head);
+  ++m_size;
+}
+
+template <typename T>
+void SnapshotHashSet<T>::erase(const T& value) {
+  if (!contains(value)) {
+    return;
+  }
+  const std::size_t index = bucketIndex(value);
+  Segment* segment = writableSegment(index / SEGMENT_SIZE);
+  Node** link = &segment->buckets[index % SEGMENT_SIZE];
+  while (!((*link)->value == value)) {
+    link = &(*link)->next;
+  }
+  Node* target = *link;
+  *link = target->next;
+  delete target;
+  --m_size;
+}
+
+template <typename T>
+void SnapshotHashSet<T>::clear() noexcept {
+  for (std::size_t s = 0; s < m_segmentCount; ++s) {
+    if (m_segments[s]->refs.load(std::memory_order_acquire) == 1) {
+      m_segments[s]->destroyChains();
+    } else {
+      // Shared segments are left to their other owners and replaced by the
+      // shared empty segment, which the next write clones like any other.
+      Segment* empty = emptySegment();
+      retain(empty);
+      release(m_segments[s]);
+      m_segments[s] = empty;
+    }
+  }
+  m_size = 0;
+}
+
+template <typename T>
+bool SnapshotHashSet<T>::contains(const T& value) const {
+  if (m_segmentCount == 0) {
+    return false;
+  }
+  const std::size_t index = bucketIndex(value);
+  const Segment* segment = m_segments[index / SEGMENT_SIZE];
+  for (const Node* current = segment->buckets[index % SEGMENT_SIZE];
+       current != nullptr;
+       current = current->next) {
+    if (current->value == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+bool SnapshotHashSet<T>::empty() const noexcept {
+  return m_size == 0;
+}
+
+template <typename T>
+std::size_t SnapshotHashSet<T>::size() const noexcept {
+  return m_size;
+}
+
+template <typename T>
+std::size_t SnapshotHashSet<T>::capacity() const noexcept {
+  return m_segmentCount * SEGMENT_SIZE;
+}
+
+template <typename T>
+std::size_t SnapshotHashSet<T>::bucketIndex(const T& value) const {
+  return std::hash<T>{}(value) % capacity();
+}
+
+template <typename T>
+typename SnapshotHashSet<T>::Segment* SnapshotHashSet<T>::writableSegment(
+    std::size_t segment) {
+  Segment* current = m_segments[segment];
+  if (current->refs.load(std::memory_order_acquire) != 1) {
+    Segment* copy = new Segment(*current);
+    release(current);
+    m_segments[segment] = copy;
+    current = copy;
+  }
+  return current;
+}
+
+template <typename T>
+void SnapshotHashSet<T>::rehash() {
+  const std::size_t new_count = m_segmentCount == 0 ? 1 : m_segmentCount * 2;
+  const std::size_t new_capacity = new_count * SEGMENT_SIZE;
+  Segment** new_segments = new Segment*[new_count]();
+  const auto headFor = [&](const T& value) -> Node*& {
+    const std::size_t index = std::hash<T>{}(value) % new_capacity;
+    return new_segments[index / SEGMENT_SIZE]->buckets[index % SEGMENT_SIZE];
+  };
+
+  // Everything that can throw happens before the old table is touched:
+  // segments shared with snapshots must stay intact for them, so their
+  // elements are copied first. Sharing is decided once, since a snapshot
+  // released meanwhile could otherwise make a segment look exclusive in
+  // the second pass after it was copied in the first.
+  std::vector<char> shared;
+  try {
+    shared.resize(m_segmentCount);
+    for (std::size_t s = 0; s < new_count; ++s) {
+      new_segments[s] = new Segment();
+    }
+    for (std::size_t s = 0; s < m_segmentCount; ++s) {
+      const Segment* segment = m_segments[s];
+      shared[s] = segment->refs.load(std::memory_order_acquire) != 1;
+      if (!shared[s]) {
+        continue;
+      }
+      for (std::size_t b = 0; b < SEGMENT_SIZE; ++b) {
+        for (const Node* node = segment->buckets[b]; node != nullptr;
+             node = node->next) {
+          Node*& head = headFor(node->value);
+          head = new Node(node->value, head);
+        }
+      }
+    }
+  } catch (...) {
+    for (std::size_t s = 0; s < new_count; ++s) {
+      delete new_segments[s];
+    }
+    delete[] new_segments;
+    throw;
+  }
+
+  // A segment nobody else sees donates its nodes.
+  for (std::size_t s = 0; s < m_segmentCount; ++s) {
+    if (shared[s]) {
+      continue;
+    }
+    Segment* segment = m_segments[s];
+    for (std::size_t b = 0; b < SEGMENT_SIZE; ++b) {
+      Node* node = segment->buckets[b];
+      while (node != nullptr) {
+        Node* next = node->next;
+        Node*& head = headFor(node->value);
+        node->next = head;
+        head = node;
+        node = next;
+      }
+      segment->buckets[b] = nullptr;
+    }
+  }
+
+  releaseSegments();
+  m_segments = new_segments;
+  m_segmentCount = new_count;
+}
+
+template <typename T>
+void SnapshotHashSet<T>::releaseSegments() noexcept {
+  for (std::size_t s = 0; s < m_segmentCount; ++s) {
+    release(m_segments[s]);
+  }
+  delete[] m_segments;
+  m_segments = nullptr;
+  m_segmentCount = 0;
+}
+
+template <typename T>
+void SnapshotHashSet<T>::shareFrom(const SnapshotHashSet& other) {
+  m_segments = new Segment*[other.m_segmentCount];
+  for (std::size_t s = 0; s < other.m_segmentCount; ++s) {
+    retain(other.m_segments[s]);
+    m_segments[s] = other.m_segments[s];
+  }
+  m_segmentCount = other.m_segmentCount;
+  m_size = other.m_size;
+}
+
+// Built in static storage on first use and never destroyed; the reference
+// it holds itself keeps its count above one, so every owner treats it as
+// shared and nothing ever deletes it.
+template <typename T>
+typename SnapshotHashSet<T>::Segment*
+SnapshotHashSet<T>::emptySegment() noexcept {
+  alignas(Segment) static unsigned char storage[sizeof(Segment)];
+  static Segment* const empty = new (storage) Segment();
+  return empty;
+}
+
+template <typename T>
+void SnapshotHashSet<T>::retain(Segment* segment) noexcept {
+  segment->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename T>
+void SnapshotHashSet<T>::release(Segment* segment) noexcept {
+  if (segment->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete segment;
+  }
+}
+
+template class SnapshotHashSet<int>;
+template class SnapshotHashSet<std::string>;
+template class SnapshotHashSet<double>;
+template class SnapshotHashSet<char>;
+template class SnapshotHashSet<float>;
+template class SnapshotHashSet<bool>;
+template class SnapshotHashSet<long>;
+template class SnapshotHashSet<short>;
@@ -0,0 +1,123 @@
+#ifndef SORTING_HPP
+#define SORTING_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Below this size std::sort beats the fixed cost of the radix histograms.
+constexpr std::size_t RADIX_SORT_THRESHOLD = 256;
+// Below this size starting threads costs more than it saves.
+constexpr std::size_t PARALLEL_SORT_THRESHOLD = std::size_t{1} << 16;
+constexpr std::size_t MAX_SORT_THREADS = 8;
+
+// Maps an integral value to an unsigned key with the same order: the bit
+// pattern truncated to the width of T, with the sign bit flipped for signed
+// types.
+template <typename T>
+std::uint64_t radixKey(T value) noexcept {
+  constexpr unsigned bits = sizeof(T) * 8;
+  std::uint64_t key = static_cast<std::uint64_t>(value);
+  if constexpr (bits < 64) {
+    key &= (std::uint64_t{1} << bits) - 1;
+  }
+  if constexpr (std::is_signed_v<T>) {
+    key ^= std::uint64_t{1} << (bits - 1);
+  }
+  return key;
+}
+
+// LSD radix sort on bytes. All histograms are built in one pass, and a
+// pass whose byte is the same for every value is skipped, so small keys in
+// wide types cost only the bytes that vary.
+template <typename T>
+void radixSort(T* data, std::size_t size) {
+  static_assert(std::is_integral_v<T>, "radixSort needs integral values");
+  if (size < RADIX_SORT_THRESHOLD) {
+    std::sort(data, data + size);
+    return;
+  }
+
+  std::array<std::array<std::size_t, 256>, sizeof(T)> counts{};
+  for (std::size_t i = 0; i < size; ++i) {
+    const std::uint64_t key = radixKey(data[i]);
+    for (std::size_t digit = 0; digit < sizeof(T); ++digit) {
+      ++counts[digit][(key >> (8 * digit)) & 0xff];
+    }
+  }
+
+  std::vector<T> scratch(size);
+  T* from = data;
+  T* to = scratch.data();
+  for (std::size_t digit = 0; digit < sizeof(T); ++digit) {
+    std::array<std::size_t, 256>& count = counts[digit];
+    if (count[(radixKey(from[0]) >> (8 * digit)) & 0xff] == size) {
+      continue;
+    }
+    std::size_t offset = 0;
+    for (std::size_t& bucket : count) {
+      const std::size_t bucket_size = bucket;
+      bucket = offset;
+      offset += bucket_size;
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+      to[count[(radixKey(from[i]) >> (8 * digit)) & 0xff]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != data) {
+    std::copy(from, from + size, data);
+  }
+}
+
+// Sorts chunks on separate threads, then merges neighbouring runs, also in
+// parallel, until one run is left. Small inputs use std::sort directly.
+template <typename Iterator, typename Compare>
+void parallelSort(Iterator first, Iterator last, Compare less) {
+  const std::size_t size = static_cast<std::size_t>(last - first);
+  std::size_t threads = std::min<std::size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), MAX_SORT_THREADS);
+  if (size < PARALLEL_SORT_THRESHOLD || threads == 1) {
+    std::sort(first, last, less);
+    return;
+  }
+
+  std::vector<Iterator> bounds;
+  for (std::size_t i = 0; i <= threads; ++i) {
+    bounds.push_back(first + size * i / threads);
+  }
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < threads; ++i) {
+    workers.emplace_back(
+        [&bounds, &less, i] { std::sort(bounds[i], bounds[i + 1], less); });
+  }
+  std::sort(bounds[0], bounds[1], less);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  while (bounds.size() > 2) {
+    std::vector<Iterator> merged;
+    workers.clear();
+    for (std::size_t i = 0; i + 2 < bounds.size(); i += 2) {
+      merged.push_back(bounds[i]);
+      workers.emplace_back([&bounds, &less, i] {
+        std::inplace_merge(bounds[i], bounds[i + 1], bounds[i + 2], less);
+      });
+    }
+    if (bounds.size() % 2 == 0) {
+      merged.push_back(bounds[bounds.size() - 2]);
+    }
+    merged.push_back(bounds.back());
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    bounds = std::move(merged);
+  }
+}
+
+#endif
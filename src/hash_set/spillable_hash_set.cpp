@@ -0,0 +1,476 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <hash_set/hash_mix.hpp>
+#include <hash_set/spillable_hash_set.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+constexpr std::uint64_t FILTER_SALT = 0x2545f4914f6cdd1dULL;
+
+void writeBytes(std::FILE* file, const void* data, std::size_t bytes) {
+  if (bytes != 0 && std::fwrite(data, 1, bytes, file) != bytes) {
+    throw std::runtime_error("SpillableHashSet: write failed");
+  }
+}
+
+// A run is a sorted sequence of fixed-size records.
+template <typename T>
+struct RunFormat {
+  static_assert(std::is_trivially_copyable_v<T>);
+  using Key = T;
+
+  static std::size_t count(const char*, std::size_t bytes) noexcept {
+    return bytes / sizeof(T);
+  }
+
+  static Key at(const char* run, std::size_t, std::size_t i) noexcept {
+    T value;
+    std::memcpy(&value, run + i * sizeof(T), sizeof(T));
+    return value;
+  }
+
+  class Writer {
+   public:
+    explicit Writer(std::FILE* file) : m_file(file) {
+    }
+
+    void add(const T& value) {
+      writeBytes(m_file, &value, sizeof(T));
+    }
+
+    void finish() {
+    }
+
+   private:
+    std::FILE* m_file;
+  };
+};
+
+// String runs store length-prefixed records followed by a table of record
+// offsets and the record count, so lookups can binary search in place.
+template <>
+struct RunFormat<std::string> {
+  using Key = std::string_view;
+
+  static std::size_t count(const char* run, std::size_t bytes) noexcept {
+    std::uint64_t count;
+    std::memcpy(&count, run + bytes - sizeof(count), sizeof(count));
+    return count;
+  }
+
+  static Key at(const char* run, std::size_t bytes, std::size_t i) noexcept {
+    const std::size_t records = count(run, bytes);
+    const char* offsets =
+        run + bytes - sizeof(std::uint64_t) * (records + 1);
+    std::uint64_t offset;
+    std::memcpy(&offset, offsets + i * sizeof(offset), sizeof(offset));
+    std::uint32_t length;
+    std::memcpy(&length, run + offset, sizeof(length));
+    return Key(run + offset + sizeof(length), length);
+  }
+
+  class Writer {
+   public:
+    explicit Writer(std::FILE* file) : m_file(file), m_position(0) {
+    }
+
+    void add(std::string_view value) {
+      const auto length = static_cast<std::uint32_t>(value.size());
+      m_offsets.push_back(m_position);
+      writeBytes(m_file, &length, sizeof(length));
+      writeBytes(m_file, value.data(), value.size());
+      m_position += sizeof(length) + value.size();
+    }
+
+    void finish() {
+      const std::uint64_t records = m_offsets.size();
+      writeBytes(
+          m_file, m_offsets.data(), m_offsets.size() * sizeof(std::uint64_t));
+      writeBytes(m_file, &records, sizeof(records));
+    }
+
+   private:
+    std::FILE* m_file;
+    std::uint64_t m_position;
+    std::vector<std::uint64_t> m_offsets;
+  };
+};
+
+template <typename T>
+bool searchRun(const char* run, std::size_t bytes, const T& value) {
+  using Format = RunFormat<T>;
+  std::size_t low = 0;
+  std::size_t high = Format::count(run, bytes);
+  while (low < high) {
+    const std::size_t middle = low + (high - low) / 2;
+    if (Format::at(run, bytes, middle) < value) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low < Format::count(run, bytes) &&
+      Format::at(run, bytes, low) == value;
+}
+
+// Rough heap cost of one element: the chain node, its share of the bucket
+// array and any out-of-line payload.
+template <typename T>
+std::size_t approximateBytes(const T&) {
+  return sizeof(T) + 2 * sizeof(void*);
+}
+
+std::size_t approximateBytes(const std::string& value) {
+  constexpr std::size_t inline_capacity = 15;
+  const std::size_t payload =
+      value.capacity() > inline_capacity ? value.capacity() + 1 : 0;
+  return sizeof(std::string) + 2 * sizeof(void*) + payload;
+}
+
+const char* mapRun(const std::string& path, std::size_t& bytes) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("SpillableHashSet: cannot open run " + path);
+  }
+  struct stat info {};
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    throw std::runtime_error("SpillableHashSet: cannot stat run " + path);
+  }
+  bytes = static_cast<std::size_t>(info.st_size);
+  if (bytes == 0) {
+    close(fd);
+    return nullptr;
+  }
+  void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    throw std::runtime_error("SpillableHashSet: cannot map run " + path);
+  }
+  madvise(mapped, bytes, MADV_RANDOM);
+  return static_cast<const char*>(mapped);
+}
+
+}  // namespace
+
+template <typename T>
+SpillableHashSet<T>::Run::Run() : data(nullptr), bytes(0), tier(0) {
+}
+
+template <typename T>
+SpillableHashSet<T>::Partition::Partition() : bytes(0) {
+}
+
+template <typename T>
+SpillableHashSet<T>::SpillableHashSet(
+    std::size_t memory_budget,
+    std::string directory,
+    std::size_t partitions)
+    : m_partitions(partitions == 0 ? 1 : partitions),
+      m_directory(std::move(directory)),
+      m_budget(memory_budget),
+      m_residentBytes(0),
+      m_filterBytes(0),
+      m_size(0),
+      m_nextRun(0) {
+}
+
+template <typename T>
+SpillableHashSet<T>::~SpillableHashSet() {
+  for (auto& partition : m_partitions) {
+    for (auto& run : partition.runs) {
+      removeRun(run);
+    }
+  }
+}
+
+template <typename T>
+bool SpillableHashSet<T>::insert(const T& value) {
+  const std::uint64_t mixed = mix(std::hash<T>{}(value));
+  Partition& partition = m_partitions[partitionIndex(mixed)];
+  if (find(partition, mixed, value)) {
+    return false;
+  }
+
+  partition.values.insert(value);
+  const std::size_t bytes = approximateBytes(value);
+  partition.bytes += bytes;
+  m_residentBytes += bytes;
+  ++m_size;
+  enforceBudget();
+  return true;
+}
+
+template <typename T>
+bool SpillableHashSet<T>::contains(const T& value) const {
+  const std::uint64_t mixed = mix(std::hash<T>{}(value));
+  return find(m_partitions[partitionIndex(mixed)], mixed, value);
+}
+
+template <typename T>
+bool SpillableHashSet<T>::empty() const noexcept {
+  return m_size == 0;
+}
+
+template <typename T>
+std::size_t SpillableHashSet<T>::size() const noexcept {
+  return m_size;
+}
+
+template <typename T>
+std::size_t SpillableHashSet<T>::resident_bytes() const noexcept {
+  return m_residentBytes;
+}
+
+template <typename T>
+std::size_t SpillableHashSet<T>::filter_bytes() const noexcept {
+  return m_filterBytes;
+}
+
+template <typename T>
+std::size_t SpillableHashSet<T>::spilled_partitions() const noexcept {
+  std::size_t spilled = 0;
+  for (const auto& partition : m_partitions) {
+    spilled += partition.runs.empty() ? 0 : 1;
+  }
+  return spilled;
+}
+
+template <typename T>
+std::size_t SpillableHashSet<T>::partitionIndex(
+    std::uint64_t mixed) const noexcept {
+  return mixed % m_partitions.size();
+}
+
+template <typename T>
+std::string SpillableHashSet<T>::runPath(std::size_t index) {
+  return m_directory + "/partition-" + std::to_string(index) + "-" +
+      std::to_string(m_nextRun++) + ".run";
+}
+
+template <typename T>
+bool SpillableHashSet<T>::find(
+    const Partition& partition,
+    std::uint64_t mixed,
+    const T& value) const {
+  if (partition.values.contains(value)) {
+    return true;
+  }
+  for (auto run = partition.runs.rbegin(); run != partition.runs.rend();
+       ++run) {
+    if (mayContain(run->filter, mixed) &&
+        searchRun(run->data, run->bytes, value)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Writes the buffered elements of a partition to a new run and frees the
+// buffer. The partition's earlier runs are left alone until compact()
+// decides they are due for a merge.
+template <typename T>
+void SpillableHashSet<T>::spill(std::size_t index) {
+  Partition& partition = m_partitions[index];
+
+  std::vector<T> buffered(partition.values.begin(), partition.values.end());
+  std::sort(buffered.begin(), buffered.end());
+  Run run = writeRun(index, 0, buffered.size(), [&](auto&& add) {
+    for (const auto& value : buffered) {
+      add(value);
+    }
+  });
+
+  m_filterBytes += filterBytes(run);
+  partition.runs.push_back(std::move(run));
+  m_residentBytes -= partition.bytes;
+  partition.bytes = 0;
+  partition.values = HashSet<T>();
+  compact(index);
+}
+
+// Merges the newest TIER_FANOUT runs into one of the next tier while they
+// share a tier. Since every tier then holds fewer than TIER_FANOUT runs, a
+// partition has O(TIER_FANOUT * log(spills)) runs at any time.
+template <typename T>
+void SpillableHashSet<T>::compact(std::size_t index) {
+  using Format = RunFormat<T>;
+  std::vector<Run>& runs = m_partitions[index].runs;
+  while (runs.size() >= TIER_FANOUT &&
+         runs[runs.size() - TIER_FANOUT].tier == runs.back().tier) {
+    const std::size_t first = runs.size() - TIER_FANOUT;
+    std::vector<std::size_t> positions(TIER_FANOUT, 0);
+    std::vector<std::size_t> counts(TIER_FANOUT);
+    std::size_t records = 0;
+    for (std::size_t i = 0; i < TIER_FANOUT; ++i) {
+      const Run& run = runs[first + i];
+      counts[i] = Format::count(run.data, run.bytes);
+      records += counts[i];
+    }
+
+    // The runs hold disjoint keys, so a plain k-way merge keeps them unique.
+    auto emit = [&](auto&& add) {
+      while (true) {
+        std::size_t smallest = TIER_FANOUT;
+        typename Format::Key smallest_key{};
+        for (std::size_t i = 0; i < TIER_FANOUT; ++i) {
+          if (positions[i] == counts[i]) {
+            continue;
+          }
+          const Run& run = runs[first + i];
+          const auto key = Format::at(run.data, run.bytes, positions[i]);
+          if (smallest == TIER_FANOUT || key < smallest_key) {
+            smallest = i;
+            smallest_key = key;
+          }
+        }
+        if (smallest == TIER_FANOUT) {
+          return;
+        }
+        add(smallest_key);
+        ++positions[smallest];
+      }
+    };
+    Run merged = writeRun(index, runs.back().tier + 1, records, emit);
+
+    for (std::size_t i = first; i < runs.size(); ++i) {
+      m_filterBytes -= filterBytes(runs[i]);
+      removeRun(runs[i]);
+    }
+    runs.erase(runs.begin() + static_cast<std::ptrdiff_t>(first), runs.end());
+    m_filterBytes += filterBytes(merged);
+    runs.push_back(std::move(merged));
+  }
+}
+
+// Spilling the largest buffer first writes as few runs as possible.
+template <typename T>
+void SpillableHashSet<T>::enforceBudget() {
+  while (m_residentBytes > m_budget) {
+    std::size_t largest = m_partitions.size();
+    std::size_t largest_bytes = 0;
+    for (std::size_t i = 0; i < m_partitions.size(); ++i) {
+      if (m_partitions[i].bytes > largest_bytes) {
+        largest = i;
+        largest_bytes = m_partitions[i].bytes;
+      }
+    }
+    if (largest == m_partitions.size()) {
+      return;
+    }
+    spill(largest);
+  }
+}
+
+// Creates a run of partition index from the records keys that emit passes,
+// in ascending order, to the callback it is given, and maps it. The run's
+// filter is filled as the keys go by.
+template <typename T>
+template <typename Emit>
+typename SpillableHashSet<T>::Run SpillableHashSet<T>::writeRun(
+    std::size_t index,
+    std::size_t tier,
+    std::size_t records,
+    Emit emit) {
+  using Format = RunFormat<T>;
+  Run run;
+  run.path = runPath(index);
+  run.tier = tier;
+  const std::size_t bits =
+      std::max(MIN_FILTER_BITS, records * FILTER_BITS_PER_KEY);
+  run.filter.assign((bits + 63) / 64, 0);
+
+  std::FILE* file = std::fopen(run.path.c_str(), "wb");
+  if (file == nullptr) {
+    throw std::runtime_error("SpillableHashSet: cannot write " + run.path);
+  }
+  try {
+    typename Format::Writer writer(file);
+    emit([&](const typename Format::Key& key) {
+      writer.add(key);
+      addToFilter(
+          run.filter, mix(std::hash<typename Format::Key>{}(key)));
+    });
+    writer.finish();
+  } catch (...) {
+    std::fclose(file);
+    std::remove(run.path.c_str());
+    throw;
+  }
+  if (std::fclose(file) != 0) {
+    std::remove(run.path.c_str());
+    throw std::runtime_error("SpillableHashSet: cannot write " + run.path);
+  }
+  try {
+    run.data = mapRun(run.path, run.bytes);
+  } catch (...) {
+    std::remove(run.path.c_str());
+    throw;
+  }
+  return run;
+}
+
+template <typename T>
+void SpillableHashSet<T>::addToFilter(
+    std::vector<std::uint64_t>& filter,
+    std::uint64_t mixed) {
+  const std::uint64_t hash = mix(mixed ^ FILTER_SALT);
+  const std::uint64_t step = (hash >> 32) | 1;
+  const std::size_t bits = filter.size() * 64;
+  for (std::size_t i = 0; i < FILTER_HASHES; ++i) {
+    const std::size_t bit = (hash + i * step) % bits;
+    filter[bit / 64] |= std::uint64_t{1} << (bit % 64);
+  }
+}
+
+template <typename T>
+bool SpillableHashSet<T>::mayContain(
+    const std::vector<std::uint64_t>& filter,
+    std::uint64_t mixed) {
+  const std::uint64_t hash = mix(mixed ^ FILTER_SALT);
+  const std::uint64_t step = (hash >> 32) | 1;
+  const std::size_t bits = filter.size() * 64;
+  for (std::size_t i = 0; i < FILTER_HASHES; ++i) {
+    const std::size_t bit = (hash + i * step) % bits;
+    if ((filter[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+std::size_t SpillableHashSet<T>::filterBytes(const Run& run) noexcept {
+  return run.filter.size() * sizeof(std::uint64_t);
+}
+
+template <typename T>
+void SpillableHashSet<T>::removeRun(Run& run) noexcept {
+  if (run.data != nullptr) {
+    munmap(const_cast<char*>(run.data), run.bytes);
+    run.data = nullptr;
+    run.bytes = 0;
+  }
+  std::remove(run.path.c_str());
+}
+
+template class SpillableHashSet<int>;
+template class SpillableHashSet<std::string>;
+template class SpillableHashSet<double>;
+template class SpillableHashSet<char>;
+template class SpillableHashSet<float>;
+template class SpillableHashSet<bool>;
+template class SpillableHashSet<long>;
+template class SpillableHashSet<short>;
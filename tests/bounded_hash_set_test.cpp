@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <hash_set/bounded_hash_set.hpp>
+#include <string>
+
+using Clock = BoundedHashSet<long>::clock;
+
+TEST(BoundedHashSetTest, EvictsOldestWhenFull) {
+  BoundedHashSet<long> set(3);
+
+  EXPECT_TRUE(set.insert(1));
+  EXPECT_TRUE(set.insert(2));
+  EXPECT_TRUE(set.insert(3));
+  EXPECT_FALSE(set.insert(1));
+  EXPECT_TRUE(set.insert(4));
+
+  EXPECT_EQ(set.size(), 3);
+  EXPECT_FALSE(set.contains(1));
+  EXPECT_TRUE(set.contains(2));
+  EXPECT_TRUE(set.contains(4));
+}
+
+TEST(BoundedHashSetTest, ExpiresAfterTtl) {
+  BoundedHashSet<long> set(100, std::chrono::seconds(10));
+  const Clock::time_point start{};
+
+  EXPECT_TRUE(set.insert(1, start));
+  EXPECT_TRUE(set.insert(2, start + std::chrono::seconds(5)));
+
+  EXPECT_TRUE(set.contains(1, start + std::chrono::seconds(9)));
+  EXPECT_FALSE(set.contains(1, start + std::chrono::seconds(10)));
+  EXPECT_TRUE(set.contains(2, start + std::chrono::seconds(10)));
+
+  EXPECT_FALSE(set.insert(2, start + std::chrono::seconds(12)));
+  EXPECT_TRUE(set.insert(1, start + std::chrono::seconds(12)));
+  EXPECT_TRUE(set.contains(1, start + std::chrono::seconds(21)));
+  EXPECT_FALSE(set.contains(2, start + std::chrono::seconds(21)));
+}
+
+TEST(BoundedHashSetTest, ReclaimsExpiredIncrementally) {
+  BoundedHashSet<long> set(1000, std::chrono::seconds(1));
+  const Clock::time_point start{};
+  for (long i = 0; i < 1000; ++i) {
+    set.insert(i, start);
+  }
+
+  const auto later = start + std::chrono::seconds(2);
+  set.insert(-1, later);
+  EXPECT_GT(set.size(), 900);
+  for (long i = 1; i < 400; ++i) {
+    set.insert(-1 - i, later);
+  }
+  EXPECT_EQ(set.size(), 400);
+}
+
+TEST(BoundedHashSetTest, SlidingWindowOfStrings) {
+  BoundedHashSet<std::string> set(50);
+  for (int i = 0; i < 1000; ++i) {
+    set.insert("event-" + std::to_string(i));
+    if (i % 7 == 0) {
+      set.erase("event-" + std::to_string(i));
+    }
+  }
+
+  EXPECT_LE(set.size(), 50);
+  EXPECT_TRUE(set.contains("event-999"));
+  EXPECT_FALSE(set.contains("event-994"));
+  EXPECT_FALSE(set.contains("event-900"));
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.insert("event-999"));
+}
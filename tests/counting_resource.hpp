@@ -0,0 +1,38 @@
+#ifndef COUNTING_RESOURCE_HPP
+#define COUNTING_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+// Forwards to the new/delete resource and records what it was asked for,
+// so tests can check which allocations a container makes.
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t largest = 0;
+
+  std::size_t outstanding() const noexcept {
+    return allocations - deallocations;
+  }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    largest = bytes > largest ? bytes : largest;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+      override {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other)
+      const noexcept override {
+    return this == &other;
+  }
+};
+
+#endif
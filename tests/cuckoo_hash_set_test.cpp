@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <hash_set/cuckoo_hash_set.hpp>
+#include <string>
+
+TEST(CuckooHashSetTest, InsertEraseContains) {
+  CuckooHashSet<int> set{1, 2, 3};
+
+  set.insert(2);
+  set.insert(4);
+  set.erase(1);
+
+  EXPECT_EQ(set.size(), 3);
+  EXPECT_FALSE(set.contains(1));
+  EXPECT_TRUE(set.contains(2));
+  EXPECT_TRUE(set.contains(4));
+}
+
+TEST(CuckooHashSetTest, GrowsUnderLoad) {
+  CuckooHashSet<long> set;
+  for (long i = 0; i < 100000; ++i) {
+    set.insert(i * 4096);
+  }
+
+  EXPECT_EQ(set.size(), 100000);
+  for (long i = 0; i < 100000; ++i) {
+    ASSERT_TRUE(set.contains(i * 4096));
+  }
+  EXPECT_FALSE(set.contains(1));
+
+  for (long i = 0; i < 100000; i += 2) {
+    set.erase(i * 4096);
+  }
+  EXPECT_EQ(set.size(), 50000);
+  EXPECT_FALSE(set.contains(0));
+  EXPECT_TRUE(set.contains(4096));
+}
+
+TEST(CuckooHashSetTest, CopyAndMove) {
+  CuckooHashSet<std::string> set1;
+  for (int i = 0; i < 1000; ++i) {
+    set1.insert(std::to_string(i));
+  }
+
+  CuckooHashSet<std::string> set2(set1);
+  set2.erase("0");
+  CuckooHashSet<std::string> set3(std::move(set1));
+
+  EXPECT_EQ(set2.size(), 999);
+  EXPECT_EQ(set3.size(), 1000);
+  EXPECT_TRUE(set3.contains("0"));
+  EXPECT_TRUE(set1.empty());
+
+  set1.insert("again");
+  EXPECT_TRUE(set1.contains("again"));
+}
+
+TEST(CuckooHashSetTest, ForEachVisitsEveryElement) {
+  CuckooHashSet<int> set;
+  for (int i = 1; i <= 500; ++i) {
+    set.insert(i);
+  }
+
+  long sum = 0;
+  std::size_t count = 0;
+  set.for_each([&](int value) {
+    sum += value;
+    ++count;
+  });
+
+  EXPECT_EQ(count, 500);
+  EXPECT_EQ(sum, 500L * 501 / 2);
+}
+
+TEST(CuckooHashSetTest, KeysWithEqualHashesDoNotGrowUnbounded) {
+  // NaNs never compare equal, so every insert adds one more key with the
+  // same hash; no seed or table size can give them separate buckets.
+  CuckooHashSet<double> set;
+  for (int i = 0; i < 200; ++i) {
+    set.insert(std::nan(""));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    set.insert(i + 0.5);
+  }
+
+  EXPECT_EQ(set.size(), 1200);
+  EXPECT_LE(set.bucket_count(), 1024);
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(set.contains(i + 0.5));
+  }
+  std::size_t nans = 0;
+  set.for_each([&](double value) { nans += std::isnan(value) ? 1 : 0; });
+  EXPECT_EQ(nans, 200);
+
+  set.erase(0.5);
+  EXPECT_FALSE(set.contains(0.5));
+  EXPECT_EQ(set.size(), 1199);
+}
+
+TEST(CuckooHashSetTest, CopiesAndClearsOverflow) {
+  CuckooHashSet<double> set;
+  for (int i = 0; i < 50; ++i) {
+    set.insert(std::nan(""));
+  }
+  set.insert(1.0);
+
+  CuckooHashSet<double> copy(set);
+  std::size_t visited = 0;
+  copy.for_each([&](double) { ++visited; });
+  EXPECT_EQ(visited, 51);
+  EXPECT_TRUE(copy.contains(1.0));
+
+  set.clear();
+  visited = 0;
+  set.for_each([&](double) { ++visited; });
+  EXPECT_EQ(visited, 0);
+  EXPECT_TRUE(set.empty());
+}
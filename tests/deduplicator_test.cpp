@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <dedup/deduplicator.hpp>
+#include <dedup/line_input.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+std::string readAll(std::FILE* file) {
+  std::string contents;
+  std::rewind(file);
+  char chunk[4096];
+  std::size_t got = 0;
+  while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    contents.append(chunk, got);
+  }
+  return contents;
+}
+
+// Runs input through dedupMapped from a regular file.
+std::string dedupFile(const std::string& input, std::size_t threads) {
+  std::FILE* in = std::tmpfile();
+  std::FILE* out = std::tmpfile();
+  std::fwrite(input.data(), 1, input.size(), in);
+  std::fflush(in);
+
+  Deduplicator dedup(threads);
+  std::size_t bytes = 0;
+  EXPECT_EQ(dedupMapped(fileno(in), dedup, out, bytes), input_status::done);
+  EXPECT_EQ(bytes, input.size());
+  std::fflush(out);
+  std::string result = readAll(out);
+  std::fclose(in);
+  std::fclose(out);
+  return result;
+}
+
+// Runs input through dedupStream from a pipe, as when reading stdin.
+std::string dedupPipe(const std::string& input, std::size_t threads) {
+  int fds[2];
+  EXPECT_EQ(pipe(fds), 0);
+  std::thread writer([&] {
+    std::size_t written = 0;
+    while (written < input.size()) {
+      const ssize_t got =
+          write(fds[1], input.data() + written, input.size() - written);
+      if (got <= 0) {
+        break;
+      }
+      written += static_cast<std::size_t>(got);
+    }
+    close(fds[1]);
+  });
+  std::FILE* out = std::tmpfile();
+
+  Deduplicator dedup(threads);
+  std::size_t bytes = 0;
+  EXPECT_EQ(
+      dedupMapped(fds[0], dedup, out, bytes), input_status::not_mapped);
+  EXPECT_EQ(dedupStream(fds[0], dedup, out, bytes), input_status::done);
+  writer.join();
+  close(fds[0]);
+  EXPECT_EQ(bytes, input.size());
+  std::fflush(out);
+  std::string result = readAll(out);
+  std::fclose(out);
+  return result;
+}
+
+// Lines with many repeats, spanning several batches and read chunks.
+std::string repetitiveInput(std::string& expected) {
+  std::string input;
+  std::unordered_set<std::string> seen;
+  for (std::size_t i = 0; i < 300000; ++i) {
+    const std::string line =
+        "line-" + std::to_string(i * 7919 % 100003) + std::string(i % 7, 'x');
+    input += line;
+    input += '\n';
+    if (seen.insert(line).second) {
+      expected += line;
+      expected += '\n';
+    }
+  }
+  // A repeat and a new line at the end, neither terminated.
+  input += "line-0";
+  input += "\nlast";
+  expected += "last\n";
+  return input;
+}
+
+}  // namespace
+
+TEST(DeduplicatorTest, KeepsFirstOccurrencesInOrder) {
+  Deduplicator dedup(1);
+  std::string output;
+
+  dedup.process({"b", "a", "b", "c", "a"}, false, output);
+  dedup.process({"c", "d", "b"}, false, output);
+
+  EXPECT_EQ(output, "b\na\nc\nd\n");
+  EXPECT_EQ(dedup.distinct(), 4);
+}
+
+TEST(DeduplicatorTest, TransientLinesAreCopied) {
+  Deduplicator dedup(3);
+  std::string buffer = "abc";
+  std::string output;
+
+  dedup.process({std::string_view(buffer)}, true, output);
+  buffer = "xyz";
+  dedup.process({"abc", std::string_view(buffer)}, true, output);
+
+  EXPECT_EQ(output, "abc\nxyz\n");
+  EXPECT_EQ(dedup.distinct(), 2);
+}
+
+TEST(DeduplicatorTest, ShardedOutputMatchesSingleThread) {
+  std::vector<std::string> storage;
+  for (int i = 0; i < 20000; ++i) {
+    storage.push_back(std::to_string(i * 31 % 4099));
+  }
+  const std::vector<std::string_view> lines(storage.begin(), storage.end());
+
+  std::string single;
+  Deduplicator one(1);
+  one.process(lines, false, single);
+  for (const std::size_t threads : {2, 3, 8}) {
+    std::string sharded;
+    Deduplicator many(threads);
+    many.process(lines, false, sharded);
+    many.process(lines, false, sharded);
+    EXPECT_EQ(sharded, single);
+    EXPECT_EQ(many.distinct(), one.distinct());
+  }
+}
+
+TEST(DeduplicatorTest, LastLineWithoutNewline) {
+  EXPECT_EQ(dedupFile("a\nb\na", 1), "a\nb\n");
+  EXPECT_EQ(dedupPipe("a\nb\na", 1), "a\nb\n");
+  EXPECT_EQ(dedupFile("a\nb\nc", 2), "a\nb\nc\n");
+  EXPECT_EQ(dedupPipe("a\nb\nc", 2), "a\nb\nc\n");
+}
+
+TEST(DeduplicatorTest, MappedAndStreamedInputAgree) {
+  std::string expected;
+  const std::string input = repetitiveInput(expected);
+
+  for (const std::size_t threads : {1, 4}) {
+    EXPECT_EQ(dedupFile(input, threads), expected);
+    EXPECT_EQ(dedupPipe(input, threads), expected);
+  }
+}
+
+TEST(DeduplicatorTest, EmptyFileIsStreamed) {
+  std::FILE* in = std::tmpfile();
+  std::FILE* out = std::tmpfile();
+  Deduplicator dedup(2);
+  std::size_t bytes = 0;
+
+  EXPECT_EQ(
+      dedupMapped(fileno(in), dedup, out, bytes), input_status::not_mapped);
+  EXPECT_EQ(dedupStream(fileno(in), dedup, out, bytes), input_status::done);
+
+  EXPECT_EQ(bytes, 0);
+  EXPECT_EQ(readAll(out), "");
+  std::fclose(in);
+  std::fclose(out);
+}
+
+TEST(DeduplicatorTest, ReportsWriteErrors) {
+  std::FILE* full = std::fopen("/dev/full", "w");
+  ASSERT_NE(full, nullptr);
+  std::FILE* in = std::tmpfile();
+  const std::string input = "a\nb\na\n";
+  std::fwrite(input.data(), 1, input.size(), in);
+  std::fflush(in);
+
+  // Little enough output to sit in the stdio buffer until the flush.
+  Deduplicator mapped(1);
+  std::size_t bytes = 0;
+  EXPECT_EQ(
+      dedupMapped(fileno(in), mapped, full, bytes),
+      input_status::write_error);
+
+  std::clearerr(full);
+  Deduplicator streamed(2);
+  lseek(fileno(in), 0, SEEK_SET);
+  EXPECT_EQ(
+      dedupStream(fileno(in), streamed, full, bytes),
+      input_status::write_error);
+  std::fclose(in);
+  std::fclose(full);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <hash_set/fixed_hash_set.hpp>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Counts every allocation made through the global operator new, so tests
+// can check that a code path does not allocate. The replacement applies to
+// the whole program, which is why this file is a test executable of its
+// own rather than part of hash_set_test.
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+void* countedAllocate(std::size_t size) {
+  ++allocations;
+  if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void* countedAllocate(std::size_t size, std::align_val_t alignment) {
+  ++allocations;
+  const std::size_t align = static_cast<std::size_t>(alignment);
+  const std::size_t rounded = (size + align - 1) / align * align;
+  if (void* memory =
+          std::aligned_alloc(align, rounded == 0 ? align : rounded)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+  return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return countedAllocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return countedAllocate(size, alignment);
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+using InsertResult = FixedHashSet<int>::insert_result;
+
+TEST(FixedHashSetTest, ReportsFullInsteadOfGrowing) {
+  FixedHashSet<int> set(4);
+
+  for (int i = 1; i <= 4; ++i) {
+    EXPECT_EQ(set.insert(i), InsertResult::inserted);
+  }
+  EXPECT_EQ(set.insert(1), InsertResult::present);
+  EXPECT_EQ(set.insert(5), InsertResult::full);
+  EXPECT_FALSE(set.contains(5));
+
+  set.erase(2);
+  EXPECT_EQ(set.insert(5), InsertResult::inserted);
+  EXPECT_EQ(set.size(), 4);
+  EXPECT_FALSE(set.contains(2));
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.insert(2), InsertResult::inserted);
+}
+
+TEST(FixedHashSetTest, HotPathDoesNotAllocate) {
+  const std::size_t initial = allocations.load();
+  FixedHashSet<long> set(1 << 12);
+
+  const std::size_t before = allocations.load();
+  std::size_t inserted = 0;
+  std::size_t found = 0;
+  for (long i = 0; i < 200000; ++i) {
+    inserted += set.insert(i) ==
+        FixedHashSet<long>::insert_result::inserted;
+    found += set.contains(i - 100);
+    if (i >= 1000) {
+      set.erase(i - 1000);
+    }
+  }
+  const std::size_t after = allocations.load();
+
+  EXPECT_EQ(before, initial + 1);
+  EXPECT_EQ(after, before);
+  EXPECT_EQ(inserted, 200000);
+  EXPECT_EQ(found, 199900);
+  EXPECT_EQ(set.size(), 1000);
+}
+
+TEST(FixedHashSetTest, UsesCallerBuffer) {
+  using Set = FixedHashSet<std::string_view>;
+  // Prefixes of different lengths are distinct keys.
+  static const std::string text(1000, 'x');
+  std::vector<unsigned char> buffer(Set::buffer_size(1000));
+  std::size_t inserted = 0;
+  Set::insert_result overflow = Set::insert_result::inserted;
+  std::size_t visited = 0;
+
+  const std::size_t before = allocations.load();
+  {
+    std::pmr::monotonic_buffer_resource arena(
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    Set set(1000, &arena);
+    for (std::size_t i = 1; i <= 1000; ++i) {
+      inserted += set.insert(std::string_view(text.data(), i)) ==
+          Set::insert_result::inserted;
+    }
+    overflow = set.insert("overflow");
+    set.for_each([&](std::string_view) { ++visited; });
+  }
+  const std::size_t after = allocations.load();
+
+  EXPECT_EQ(after, before);
+  EXPECT_EQ(inserted, 1000);
+  EXPECT_EQ(overflow, Set::insert_result::full);
+  EXPECT_EQ(visited, 1000);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <hash_set/hash_map.hpp>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "counting_resource.hpp"
+
+TEST(HashMapTest, TryEmplaceKeepsExistingValue) {
+  HashMap<std::string, std::string> map;
+
+  auto [it, inserted] = map.try_emplace("key", 3, 'a');
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(it->first, "key");
+  EXPECT_EQ(it->second, "aaa");
+
+  std::tie(it, inserted) = map.try_emplace("key", "other");
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it->second, "aaa");
+  EXPECT_EQ(map.size(), 1);
+}
+
+TEST(HashMapTest, InsertOrAssign) {
+  HashMap<std::string, int> map;
+
+  EXPECT_TRUE(map.insert_or_assign("a", 1).second);
+  EXPECT_FALSE(map.insert_or_assign("a", 2).second);
+  EXPECT_TRUE(map.insert_or_assign("b", 3).second);
+
+  EXPECT_EQ(map.at("a"), 2);
+  EXPECT_EQ(map.at("b"), 3);
+  EXPECT_FALSE(map.insert({"a", 5}));
+  EXPECT_EQ(map.at("a"), 2);
+}
+
+TEST(HashMapTest, SubscriptDefaultConstructs) {
+  HashMap<std::string, int> counts;
+  for (const char* word : {"to", "be", "or", "not", "to", "be"}) {
+    ++counts[word];
+  }
+
+  EXPECT_EQ(counts.size(), 4);
+  EXPECT_EQ(counts["to"], 2);
+  EXPECT_EQ(counts["not"], 1);
+  EXPECT_EQ(counts["missing"], 0);
+  EXPECT_EQ(counts.size(), 5);
+}
+
+TEST(HashMapTest, AtThrowsOnMissingKey) {
+  const HashMap<int, int> map{{1, 10}, {2, 20}};
+
+  EXPECT_EQ(map.at(2), 20);
+  EXPECT_THROW(map.at(3), std::out_of_range);
+}
+
+TEST(HashMapTest, FindEraseAndIterate) {
+  HashMap<long, long> map;
+  for (long i = 0; i < 10000; ++i) {
+    map[i] = i * i;
+  }
+
+  EXPECT_EQ(map.size(), 10000);
+  EXPECT_EQ(map.find(77)->second, 77 * 77);
+  EXPECT_EQ(map.find(10000), map.end());
+  EXPECT_EQ(map.erase(77), 1);
+  EXPECT_EQ(map.erase(77), 0);
+  EXPECT_FALSE(map.contains(77));
+
+  for (auto it = map.begin(); it != map.end();) {
+    it = it->first % 2 == 0 ? map.erase(it) : std::next(it);
+  }
+  long sum = 0;
+  for (auto& [key, value] : map) {
+    EXPECT_EQ(key % 2, 1);
+    EXPECT_EQ(value, key * key);
+    value = 0;
+    ++sum;
+  }
+  EXPECT_EQ(sum, 4999);
+  EXPECT_EQ(map.at(1), 0);
+}
+
+TEST(HashMapTest, CopyAssignAndCompare) {
+  HashMap<std::string, int> map1{{"a", 1}, {"b", 2}};
+  HashMap<std::string, int> map2;
+  map2["c"] = 3;
+
+  map2 = map1;
+  EXPECT_TRUE(map2 == map1);
+  EXPECT_FALSE(map2.contains("c"));
+
+  map2["a"] = 5;
+  EXPECT_TRUE(map2 != map1);
+  EXPECT_EQ(map1.at("a"), 1);
+
+  HashMap<std::string, int> map3(std::move(map2));
+  EXPECT_EQ(map3.at("a"), 5);
+  EXPECT_TRUE(map2.empty());
+}
+
+TEST(HashMapTest, UsesMemoryResource) {
+  std::pmr::monotonic_buffer_resource arena;
+  HashMap<int, int> map(&arena);
+  for (int i = 0; i < 1000; ++i) {
+    map.try_emplace(i, -i);
+  }
+
+  HashMap<int, int> copy(map, &arena);
+  EXPECT_EQ(copy.resource(), &arena);
+  EXPECT_EQ(copy.at(999), -999);
+}
+
+TEST(HashMapTest, CopyAssignReplacesBlock) {
+  HashMap<long, long> source;
+  for (long i = 0; i < 1000; ++i) {
+    source.try_emplace(i, i);
+  }
+  CountingResource resource;
+  HashMap<long, long> target(source, &resource);
+  EXPECT_EQ(resource.allocations, 2);
+
+  source[0] = -1;
+  target = source;
+
+  // The old block is returned and one new block holds every entry.
+  EXPECT_EQ(resource.allocations, 3);
+  EXPECT_EQ(resource.deallocations, 1);
+  EXPECT_TRUE(target == source);
+  EXPECT_EQ(target.at(0), -1);
+}
@@ -2,8 +2,15 @@
 #include <algorithm>
 #include <hash_set/hash_set.hpp>
 #include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#include "counting_resource.hpp"
+
 TEST(HashSetTest, InsertTest) {
   HashSet<int> set;
 
@@ -381,4 +388,282 @@ TEST(HashSetTypeTest, LongTest) {
   EXPECT_TRUE(set.contains(10979679679));
   EXPECT_FALSE(set.contains(354845646345321));
   EXPECT_TRUE(set.contains(28547547457548));
-}
\ No newline at end of file
+}
+
+TEST(HashSetEraseTest, EraseByIterator) {
+  HashSet<int> set;
+  for (int i = 0; i < 100; ++i) {
+    set.insert(i);
+  }
+
+  int visited = 0;
+  for (auto it = set.begin(); it != set.end();) {
+    ++visited;
+    if (*it % 3 == 0) {
+      it = set.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  EXPECT_EQ(visited, 100);
+  EXPECT_EQ(set.size(), 66);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(set.contains(i), i % 3 != 0);
+  }
+}
+
+TEST(HashSetEraseTest, EraseLastReturnsEnd) {
+  HashSet<int> set{42};
+
+  auto it = set.erase(set.begin());
+
+  EXPECT_EQ(it, set.end());
+  EXPECT_TRUE(set.empty());
+}
+
+TEST(HashSetEraseTest, EraseIf) {
+  HashSet<int> set;
+  for (int i = 0; i < 1000; ++i) {
+    set.insert(i);
+  }
+
+  auto removed = erase_if(set, [](int x) { return x % 2 == 0; });
+
+  EXPECT_EQ(removed, 500);
+  EXPECT_EQ(set.size(), 500);
+  EXPECT_FALSE(set.contains(0));
+  EXPECT_TRUE(set.contains(999));
+  EXPECT_EQ(std::distance(set.begin(), set.end()), 500);
+}
+
+TEST(HashSetResourceTest, AllocatesFromResource) {
+  CountingResource resource;
+  {
+    HashSet<int> set(&resource);
+    for (int i = 0; i < 100; ++i) {
+      set.insert(i);
+    }
+    EXPECT_EQ(set.resource(), &resource);
+    EXPECT_GT(resource.allocations, 100);
+  }
+  EXPECT_EQ(resource.allocations, resource.deallocations);
+}
+
+TEST(HashSetResourceTest, MonotonicResourceSkipsDeallocation) {
+  CountingResource upstream;
+  {
+    std::pmr::monotonic_buffer_resource arena(&upstream);
+    {
+      HashSet<std::string> set(&arena);
+      for (int i = 0; i < 100; ++i) {
+        set.insert(std::string(32, static_cast<char>('a' + i % 26)) +
+                   std::to_string(i));
+      }
+      EXPECT_EQ(set.size(), 100);
+      EXPECT_TRUE(set.contains(std::string(32, 'a') + "0"));
+    }
+    EXPECT_EQ(upstream.deallocations, 0);
+  }
+  EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(HashSetResourceTest, CopyUsesDefaultResource) {
+  std::pmr::monotonic_buffer_resource arena;
+  HashSet<int> set({1, 2, 3}, &arena);
+
+  HashSet<int> copy(set);
+  HashSet<int> moved(std::move(set));
+
+  EXPECT_EQ(copy.resource(), std::pmr::get_default_resource());
+  EXPECT_EQ(moved.resource(), &arena);
+  EXPECT_TRUE(copy == moved);
+}
+
+TEST(HashSetCopyTest, CopyThenModify) {
+  HashSet<std::string> set1;
+  for (int i = 0; i < 200; ++i) {
+    set1.insert("value" + std::to_string(i));
+  }
+
+  HashSet<std::string> set2(set1);
+  set2.erase("value0");
+  set2.insert("extra");
+  for (int i = 200; i < 400; ++i) {
+    set2.insert("value" + std::to_string(i));
+  }
+
+  EXPECT_EQ(set1.size(), 200);
+  EXPECT_EQ(set2.size(), 400);
+  EXPECT_TRUE(set1.contains("value0"));
+  EXPECT_FALSE(set2.contains("value0"));
+  EXPECT_TRUE(set2.contains("value399"));
+}
+
+TEST(HashSetCopyTest, CopyAssignmentReusesAndGrows) {
+  HashSet<std::string> small{"a", "b"};
+  HashSet<std::string> large;
+  for (int i = 0; i < 100; ++i) {
+    large.insert(std::to_string(i));
+  }
+
+  HashSet<std::string> target(small);
+  target = large;
+  EXPECT_TRUE(target == large);
+
+  target = small;
+  EXPECT_TRUE(target == small);
+  EXPECT_FALSE(target.contains("0"));
+
+  target = HashSet<std::string>();
+  target = large;
+  EXPECT_TRUE(target == large);
+}
+
+TEST(HashSetCopyTest, CopyAssignmentFromMovedFrom) {
+  HashSet<int> source{1, 2, 3};
+  HashSet<int> target(std::move(source));
+
+  HashSet<int> other{4, 5};
+  source = other;
+
+  EXPECT_TRUE(source == other);
+  EXPECT_EQ(target.size(), 3);
+}
+
+TEST(HashSetCopyTest, ErasingCopiedElementsReleasesBlock) {
+  HashSet<long> set;
+  for (long i = 0; i < 1000; ++i) {
+    set.insert(i);
+  }
+  CountingResource resource;
+  HashSet<long> copy(set, &resource);
+  // The bucket array and a single block holding every node.
+  EXPECT_EQ(resource.allocations, 2);
+
+  for (long i = 0; i < 999; ++i) {
+    copy.erase(i);
+  }
+  EXPECT_EQ(resource.deallocations, 0);
+  copy.erase(999);
+  EXPECT_EQ(resource.deallocations, 1);
+
+  copy.insert(7);
+  EXPECT_TRUE(copy.contains(7));
+  EXPECT_EQ(copy.size(), 1);
+}
+
+TEST(HashSetTest, InsertReportsWhetherAdded) {
+  HashSet<std::string_view> set;
+
+  EXPECT_TRUE(set.insert("first"));
+  EXPECT_FALSE(set.insert("first"));
+  EXPECT_TRUE(set.insert("second"));
+  EXPECT_EQ(set.size(), 2);
+}
+
+TEST(HashSetOrderTest, SortsSignedIntegers) {
+  HashSet<long> set;
+  std::vector<long> expected;
+  for (long i = -5000; i < 5000; ++i) {
+    const long value = i * 7919 % 100003;
+    if (set.insert(value)) {
+      expected.push_back(value);
+    }
+  }
+  set.insert(std::numeric_limits<long>::min());
+  set.insert(std::numeric_limits<long>::max());
+  expected.push_back(std::numeric_limits<long>::min());
+  expected.push_back(std::numeric_limits<long>::max());
+  std::sort(expected.begin(), expected.end());
+
+  EXPECT_EQ(set.to_sorted_vector(), expected);
+}
+
+TEST(HashSetOrderTest, SortsSmallTypes) {
+  HashSet<char> chars{'z', 'a', -3, 'm', 0};
+  HashSet<short> shorts{300, -300, 7, -32768, 32767};
+  HashSet<bool> bools{true, false};
+
+  EXPECT_EQ(
+      chars.to_sorted_vector(), (std::vector<char>{-3, 0, 'a', 'm', 'z'}));
+  EXPECT_EQ(
+      shorts.to_sorted_vector(),
+      (std::vector<short>{-32768, -300, 7, 300, 32767}));
+  EXPECT_EQ(bools.to_sorted_vector(), (std::vector<bool>{false, true}));
+}
+
+TEST(HashSetOrderTest, SortsLargeStringSets) {
+  HashSet<std::string> set;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 100000; ++i) {
+    expected.push_back("key-" + std::to_string(i * 37 % 100000));
+    set.insert(expected.back());
+  }
+  std::sort(expected.begin(), expected.end());
+
+  EXPECT_EQ(set.to_sorted_vector(), expected);
+}
+
+TEST(HashSetOrderTest, OrderedViewFollowsModifications) {
+  HashSet<int> set{3, 1, 2};
+  EXPECT_EQ(set.ordered_view(), (std::vector<int>{1, 2, 3}));
+
+  set.insert(0);
+  EXPECT_EQ(set.ordered_view(), (std::vector<int>{0, 1, 2, 3}));
+  set.erase(2);
+  EXPECT_EQ(set.ordered_view(), (std::vector<int>{0, 1, 3}));
+  erase_if(set, [](int value) { return value == 0; });
+  EXPECT_EQ(set.ordered_view(), (std::vector<int>{1, 3}));
+  set = HashSet<int>{9, 8};
+  EXPECT_EQ(set.ordered_view(), (std::vector<int>{8, 9}));
+  set.clear();
+  EXPECT_TRUE(set.ordered_view().empty());
+  // The cache built for {8, 9} went with the elements.
+  EXPECT_EQ(set.ordered_view().capacity(), 0);
+}
+
+TEST(HashSetOrderTest, ConcurrentReadersShareTheCache) {
+  HashSet<std::string> set;
+  HashSet<std::string> other;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 5000; ++i) {
+    set.insert(std::to_string(i));
+    other.insert(std::to_string(i + 1));
+    expected.push_back(std::to_string(i));
+  }
+  std::sort(expected.begin(), expected.end());
+
+  std::vector<int> results(4, 0);
+  std::vector<std::thread> readers;
+  for (std::size_t t = 0; t < results.size(); ++t) {
+    readers.emplace_back([&, t] {
+      results[t] = (set < other) && set.to_sorted_vector() == expected &&
+          &set.ordered_view() == &set.ordered_view();
+    });
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(results, (std::vector<int>{1, 1, 1, 1}));
+}
+
+TEST(HashSetOrderTest, ComparisonIgnoresInsertionHistory) {
+  HashSet<int> grown;
+  for (int i = 0; i < 1000; ++i) {
+    grown.insert(i);
+  }
+  for (int i = 10; i < 1000; ++i) {
+    grown.erase(i);
+  }
+  HashSet<int> fresh{9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+  HashSet<int> bigger{0, 1, 2, 3, 4, 5, 6, 7, 8, 10};
+
+  EXPECT_TRUE(grown == fresh);
+  EXPECT_FALSE(grown < fresh);
+  EXPECT_FALSE(fresh < grown);
+  EXPECT_TRUE(grown < bigger);
+  EXPECT_TRUE(fresh < bigger);
+  EXPECT_TRUE(bigger > grown);
+}
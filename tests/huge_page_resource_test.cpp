@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <hash_set/hash_set.hpp>
+#include <hash_set/huge_page_resource.hpp>
+#include <memory_resource>
+
+#include "counting_resource.hpp"
+
+TEST(HugePageResourceTest, LargeAllocationIsHugePageAligned) {
+  HugePageResource resource;
+  const std::size_t bytes = 3 * HugePageResource::HUGE_PAGE_SIZE + 1;
+
+  void* p = resource.allocate(bytes, alignof(std::max_align_t));
+  const auto address = reinterpret_cast<std::uintptr_t>(p);
+
+  EXPECT_EQ(address % HugePageResource::HUGE_PAGE_SIZE, 0);
+  static_cast<char*>(p)[0] = 1;
+  static_cast<char*>(p)[bytes - 1] = 1;
+  resource.deallocate(p, bytes, alignof(std::max_align_t));
+}
+
+TEST(HugePageResourceTest, BacksLargeBucketArrays) {
+  constexpr std::size_t threshold = 4096;
+  CountingResource upstream;
+  {
+    HugePageResource resource(threshold, &upstream);
+    HashSet<long> set(&resource);
+
+    for (long i = 0; i < 100000; ++i) {
+      set.insert(i * 31);
+    }
+
+    EXPECT_EQ(set.size(), 100000);
+    EXPECT_TRUE(set.contains(31 * 99999L));
+    EXPECT_FALSE(set.contains(30));
+  }
+
+  // Nodes went upstream; the bucket arrays, which grew far past the
+  // threshold, did not.
+  EXPECT_GE(upstream.allocations, 100000);
+  EXPECT_LT(upstream.largest, threshold);
+  EXPECT_EQ(upstream.outstanding(), 0);
+}
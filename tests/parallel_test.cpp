@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <hash_set/hash_set.hpp>
+#include <hash_set/parallel.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+TEST(HashSetPartitionTest, RangesCoverEveryElementOnce) {
+  HashSet<int> set;
+  for (int i = 0; i < 1000; ++i) {
+    set.insert(i);
+  }
+
+  for (std::size_t chunks : {1, 3, 7, 64}) {
+    const auto ranges = set.partition(chunks);
+    ASSERT_EQ(ranges.size(), chunks);
+    EXPECT_EQ(ranges.front().first_bucket(), 0);
+
+    HashSet<int> seen;
+    std::size_t visited = 0;
+    for (const auto& range : ranges) {
+      for (auto it = range.begin(); it != range.end(); ++it) {
+        seen.insert(*it);
+        ++visited;
+      }
+    }
+    EXPECT_EQ(visited, set.size());
+    EXPECT_TRUE(seen == set);
+  }
+}
+
+TEST(HashSetPartitionTest, EmptySetAndSmallTable) {
+  HashSet<int> set;
+
+  const auto ranges = set.partition(1000);
+
+  EXPECT_LE(ranges.size(), 16);
+  for (const auto& range : ranges) {
+    EXPECT_EQ(range.begin(), range.end());
+  }
+}
+
+TEST(HashSetParallelTest, ReduceSumsAllElements) {
+  HashSet<long> set;
+  for (long i = 1; i <= 100000; ++i) {
+    set.insert(i);
+  }
+
+  const long sum = parallel_reduce(
+      set,
+      0L,
+      [](long acc, long value) { return acc + value; },
+      [](long lhs, long rhs) { return lhs + rhs; },
+      4);
+
+  EXPECT_EQ(sum, 100000L * 100001 / 2);
+}
+
+TEST(HashSetParallelTest, ForEachVisitsAllElements) {
+  HashSet<std::string> set;
+  for (int i = 0; i < 5000; ++i) {
+    set.insert(std::to_string(i));
+  }
+
+  std::atomic<std::size_t> visited{0};
+  std::atomic<std::size_t> characters{0};
+  parallel_for_each(
+      set,
+      [&](const std::string& value) {
+        ++visited;
+        characters += value.size();
+      },
+      8);
+
+  EXPECT_EQ(visited, 5000);
+  EXPECT_EQ(characters, 10 + 90 * 2 + 900 * 3 + 4000 * 4);
+}
+
+TEST(HashSetParallelTest, RethrowsWorkerException) {
+  HashSet<int> set{1, 2, 3, 4, 5, 6, 7, 8};
+
+  EXPECT_THROW(
+      parallel_for_each(
+          set,
+          [](int value) {
+            if (value == 5) {
+              throw std::runtime_error("boom");
+            }
+          },
+          4),
+      std::runtime_error);
+}
+
+TEST(HashSetParallelTest, ReducesKeyValueTables) {
+  HashSet<std::pair<const int, int>, FirstKey> table;
+  for (int i = 0; i < 1000; ++i) {
+    table.insert({i, 2 * i});
+  }
+
+  const long sum = parallel_reduce(
+      table,
+      0L,
+      [](long acc, const std::pair<const int, int>& entry) {
+        return acc + entry.second;
+      },
+      [](long lhs, long rhs) { return lhs + rhs; },
+      4);
+  std::atomic<std::size_t> visited{0};
+  parallel_for_each(table, [&](const auto&) { ++visited; }, 3);
+
+  EXPECT_EQ(sum, 999L * 1000);
+  EXPECT_EQ(visited, 1000);
+}
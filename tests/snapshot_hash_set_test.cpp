@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <hash_set/snapshot_hash_set.hpp>
+#include <string>
+#include <thread>
+
+TEST(SnapshotHashSetTest, InsertEraseContains) {
+  SnapshotHashSet<int> set{1, 2, 3};
+
+  set.insert(4);
+  set.erase(2);
+
+  EXPECT_EQ(set.size(), 3);
+  EXPECT_TRUE(set.contains(1));
+  EXPECT_FALSE(set.contains(2));
+  EXPECT_TRUE(set.contains(4));
+}
+
+TEST(SnapshotHashSetTest, SnapshotIsIsolatedFromWriter) {
+  SnapshotHashSet<int> set;
+  for (int i = 0; i < 1000; ++i) {
+    set.insert(i);
+  }
+
+  SnapshotHashSet<int> snapshot = set.snapshot();
+  for (int i = 0; i < 1000; i += 2) {
+    set.erase(i);
+  }
+  for (int i = 1000; i < 5000; ++i) {
+    set.insert(i);
+  }
+
+  EXPECT_EQ(snapshot.size(), 1000);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(snapshot.contains(i));
+  }
+  EXPECT_FALSE(snapshot.contains(1000));
+  EXPECT_EQ(set.size(), 4500);
+  EXPECT_FALSE(set.contains(0));
+  EXPECT_TRUE(set.contains(4999));
+}
+
+TEST(SnapshotHashSetTest, WriterDoesNotAffectSnapshotModifications) {
+  SnapshotHashSet<std::string> set{"a", "b"};
+  SnapshotHashSet<std::string> snapshot = set.snapshot();
+
+  snapshot.insert("c");
+  set.clear();
+
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(snapshot.size(), 3);
+  EXPECT_TRUE(snapshot.contains("a"));
+  EXPECT_TRUE(snapshot.contains("c"));
+}
+
+TEST(SnapshotHashSetTest, ClearedSetsShareEmptySegmentsSafely) {
+  SnapshotHashSet<int> first{1, 2, 3};
+  SnapshotHashSet<int> second{4, 5, 6};
+  SnapshotHashSet<int> first_snapshot = first.snapshot();
+  SnapshotHashSet<int> second_snapshot = second.snapshot();
+
+  first.clear();
+  second.clear();
+  first.insert(7);
+  second.insert(8);
+
+  EXPECT_EQ(first.size(), 1);
+  EXPECT_TRUE(first.contains(7));
+  EXPECT_FALSE(first.contains(8));
+  EXPECT_EQ(second.size(), 1);
+  EXPECT_TRUE(second.contains(8));
+  EXPECT_FALSE(second.contains(7));
+  EXPECT_EQ(first_snapshot.size(), 3);
+  EXPECT_TRUE(second_snapshot.contains(4));
+}
+
+TEST(SnapshotHashSetTest, ReaderThreadSeesConsistentView) {
+  SnapshotHashSet<long> set;
+  for (long i = 0; i < 10000; ++i) {
+    set.insert(i);
+  }
+
+  SnapshotHashSet<long> snapshot = set.snapshot();
+  long sum = 0;
+  std::thread reader([&snapshot, &sum] {
+    snapshot.for_each([&sum](long value) { sum += value; });
+  });
+  for (long i = 0; i < 10000; ++i) {
+    set.erase(i);
+    set.insert(i + 10000);
+  }
+  reader.join();
+
+  EXPECT_EQ(sum, 10000L * 9999 / 2);
+  EXPECT_EQ(set.size(), 10000);
+  EXPECT_FALSE(set.contains(0));
+}
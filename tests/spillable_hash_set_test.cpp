@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <hash_set/spillable_hash_set.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+
+class SpillDirectory {
+ public:
+  explicit SpillDirectory(const std::string& name)
+      : m_path(std::filesystem::temp_directory_path() / name) {
+    std::filesystem::remove_all(m_path);
+    std::filesystem::create_directories(m_path);
+  }
+
+  ~SpillDirectory() {
+    std::filesystem::remove_all(m_path);
+  }
+
+  std::string path() const {
+    return m_path.string();
+  }
+
+  bool empty() const {
+    return std::filesystem::is_empty(m_path);
+  }
+
+  // Number of run files per partition, by the partition index in the name.
+  std::vector<std::size_t> runsPerPartition(std::size_t partitions) const {
+    std::vector<std::size_t> runs(partitions);
+    for (const auto& entry : std::filesystem::directory_iterator(m_path)) {
+      const std::string name = entry.path().filename().string();
+      const std::size_t begin = name.find('-') + 1;
+      runs[std::stoul(name.substr(begin, name.find('-', begin) - begin))]++;
+    }
+    return runs;
+  }
+
+ private:
+  std::filesystem::path m_path;
+};
+
+}  // namespace
+
+TEST(SpillableHashSetTest, StaysInMemoryUnderBudget) {
+  SpillDirectory directory("spillable_hash_set_small");
+  SpillableHashSet<int> set(1 << 20, directory.path());
+
+  EXPECT_TRUE(set.insert(1));
+  EXPECT_FALSE(set.insert(1));
+  EXPECT_TRUE(set.contains(1));
+  EXPECT_FALSE(set.contains(2));
+  EXPECT_EQ(set.spilled_partitions(), 0);
+  EXPECT_TRUE(directory.empty());
+}
+
+TEST(SpillableHashSetTest, SpillsWhenBudgetIsExceeded) {
+  SpillDirectory directory("spillable_hash_set_large");
+  constexpr long keys = 200000;
+  constexpr std::size_t budget = 1024 * 1024;
+  {
+    SpillableHashSet<long> set(budget, directory.path());
+    for (long i = 0; i < keys; ++i) {
+      ASSERT_TRUE(set.insert(i * 7));
+    }
+
+    EXPECT_EQ(set.size(), keys);
+    EXPECT_GT(set.spilled_partitions(), 0);
+    EXPECT_LE(set.resident_bytes(), budget);
+
+    for (long i = 0; i < keys; i += 997) {
+      EXPECT_FALSE(set.insert(i * 7));
+      EXPECT_TRUE(set.contains(i * 7));
+      EXPECT_FALSE(set.contains(i * 7 + 1));
+    }
+    EXPECT_EQ(set.size(), keys);
+    EXPECT_LE(set.resident_bytes(), budget);
+  }
+  EXPECT_TRUE(directory.empty());
+}
+
+TEST(SpillableHashSetTest, SpillsStrings) {
+  SpillDirectory directory("spillable_hash_set_strings");
+  SpillableHashSet<std::string> set(64 * 1024, directory.path(), 16);
+
+  for (int i = 0; i < 20000; ++i) {
+    set.insert("a fairly long key number " + std::to_string(i));
+  }
+
+  EXPECT_EQ(set.size(), 20000);
+  EXPECT_GT(set.spilled_partitions(), 0);
+  EXPECT_TRUE(set.contains("a fairly long key number 0"));
+  EXPECT_TRUE(set.contains("a fairly long key number 19999"));
+  EXPECT_FALSE(set.contains("a fairly long key number 20000"));
+}
+
+TEST(SpillableHashSetTest, BudgetBelowFilterFootprint) {
+  SpillDirectory directory("spillable_hash_set_filters");
+  constexpr long keys = 100000;
+  constexpr std::size_t budget = 16 * 1024;
+  constexpr std::size_t partitions = 16;
+  SpillableHashSet<long> set(budget, directory.path(), partitions);
+
+  for (long i = 0; i < keys; ++i) {
+    ASSERT_TRUE(set.insert(i * 13));
+  }
+
+  // The filters alone outgrow the budget, which still bounds the buffer.
+  EXPECT_GT(set.filter_bytes(), budget);
+  EXPECT_LE(set.resident_bytes(), budget);
+  EXPECT_EQ(set.size(), keys);
+  for (long i = 0; i < keys; i += 101) {
+    EXPECT_TRUE(set.contains(i * 13));
+    EXPECT_FALSE(set.contains(i * 13 + 1));
+  }
+
+  // Spills add runs that are merged by tier rather than piling up: with
+  // fewer than four runs per tier, 15 runs would take over 1000 spills.
+  for (const std::size_t runs : directory.runsPerPartition(partitions)) {
+    EXPECT_LE(runs, 15);
+  }
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <hash_set/static_hash_set.hpp>
+#include <string>
+#include <string_view>
+
+namespace {
+
+constexpr auto keywords = make_static_hash_set<std::string_view>(
+    {"auto",     "break",  "case",    "char",   "const",    "continue",
+     "default",  "do",     "double",  "else",   "enum",     "extern",
+     "float",    "for",    "goto",    "if",     "int",      "long",
+     "register", "return", "short",   "signed", "sizeof",   "static",
+     "struct",   "switch", "typedef", "union",  "unsigned", "void",
+     "volatile", "while"});
+
+constexpr auto primes =
+    make_static_hash_set<int>({2, 3, 5, 7, 11, 13, 17, 19, 23, 29});
+
+static_assert(keywords.contains("while"));
+static_assert(!keywords.contains("whilst"));
+static_assert(primes.contains(13));
+static_assert(!primes.contains(15));
+
+}  // namespace
+
+TEST(StaticHashSetTest, ContainsKeywords) {
+  EXPECT_EQ(keywords.size(), 32);
+  for (const std::string word : {"auto", "int", "struct", "volatile"}) {
+    EXPECT_TRUE(keywords.contains(word));
+  }
+  for (const std::string word : {"", "Auto", "in", "structs", "class"}) {
+    EXPECT_FALSE(keywords.contains(word));
+  }
+}
+
+TEST(StaticHashSetTest, ContainsIntegers) {
+  EXPECT_EQ(primes.size(), 10);
+  int found = 0;
+  for (int i = -5; i < 100; ++i) {
+    found += primes.contains(i);
+  }
+  EXPECT_EQ(found, 10);
+}
+
+TEST(StaticHashSetTest, BuildsLargeSets) {
+  struct Keys {
+    unsigned values[500];
+  };
+  constexpr Keys keys = [] {
+    Keys result{};
+    for (unsigned i = 0; i < 500; ++i) {
+      result.values[i] = i * 7919;
+    }
+    return result;
+  }();
+  constexpr auto set = make_static_hash_set(keys.values);
+
+  EXPECT_EQ(set.size(), 500);
+  for (unsigned i = 0; i < 500 * 7919; ++i) {
+    ASSERT_EQ(set.contains(i), i % 7919 == 0) << i;
+  }
+}
+
+TEST(StaticHashSetTest, IgnoresDuplicateKeys) {
+  constexpr auto set = make_static_hash_set<long>({4, 8, 4, 15, 8});
+  static_assert(set.size() == 3);
+  EXPECT_TRUE(set.contains(15));
+  EXPECT_FALSE(set.contains(16));
+}
+
+TEST(StaticHashSetTest, SingleKey) {
+  constexpr auto set = make_static_hash_set<char>({'x'});
+  EXPECT_TRUE(set.contains('x'));
+  EXPECT_FALSE(set.contains('y'));
+  EXPECT_FALSE(set.empty());
+}